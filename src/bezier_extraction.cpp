@@ -0,0 +1,292 @@
+#include "bezier_extraction.h"
+#include "spline.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Spline {
+
+namespace {
+
+// 钳位节点向量中的不同节点 knots[degree] .. knots[n + 1]，即各 Bezier 段的参数分界
+std::vector<float> distinctBreakpoints(const std::vector<float>& knots, int numControlPoints, int degree) {
+    std::vector<float> breakpoints;
+    for (int i = degree; i <= numControlPoints; ++i) {
+        if (breakpoints.empty() || knots[i] > breakpoints.back()) breakpoints.push_back(knots[i]);
+    }
+    return breakpoints;
+}
+
+// 曲线分解（The NURBS Book, A5.6）：把每个内部节点插入到 p 重，
+// 输入 P[0..n] 以 stride 间隔存放，输出按段依次追加到 out
+void decomposeCurve(int numControlPoints, int degree, const std::vector<float>& knots,
+                    const glm::vec4* P, size_t stride, std::vector<glm::vec4>& out) {
+    const int p = degree;
+    const int m = numControlPoints + p; // 最后一个节点的下标
+    size_t base = out.size();
+    out.resize(base + p + 1);
+    for (int i = 0; i <= p; ++i) out[base + i] = P[i * stride];
+
+    std::vector<float> alphas(p);
+    int a = p;
+    int b = p + 1;
+    while (b < m) {
+        int i = b;
+        while (b < m && knots[b + 1] == knots[b]) ++b;
+        int mult = b - i + 1;
+        size_t next = out.size();
+        bool hasNext = b < m;
+        if (hasNext) out.resize(next + p + 1);
+        glm::vec4* Q = &out[out.size() - (hasNext ? 2 : 1) * (p + 1)];
+
+        if (mult < p) {
+            float numer = knots[b] - knots[a];
+            for (int j = p; j > mult; --j) {
+                alphas[j - mult - 1] = numer / (knots[a + j] - knots[a]);
+            }
+            int r = p - mult;
+            for (int j = 1; j <= r; ++j) {
+                int save = r - j;
+                int s = mult + j;
+                for (int k = p; k >= s; --k) {
+                    float alpha = alphas[k - s];
+                    Q[k] = alpha * Q[k] + (1.0f - alpha) * Q[k - 1];
+                }
+                // 下一段的前几个控制点来自本段插入过程
+                if (hasNext) Q[p + 1 + save] = Q[p];
+            }
+        }
+        if (hasNext) {
+            for (int k = p - mult; k <= p; ++k) Q[p + 1 + k] = P[(b - p + k) * stride];
+            a = b;
+            ++b;
+        }
+    }
+}
+
+glm::vec3 projectPoint(const glm::vec4& h) {
+    return std::abs(h.w) > 1e-6f ? glm::vec3(h) / h.w : glm::vec3(h);
+}
+
+void computeBounds(const glm::vec4* points, size_t count, glm::vec3& lo, glm::vec3& hi) {
+    lo = hi = projectPoint(points[0]);
+    for (size_t k = 1; k < count; ++k) {
+        glm::vec3 p = projectPoint(points[k]);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+}
+
+// 全局参数 u 所在的段号与段内局部参数
+int locateSegment(const std::vector<float>& breakpoints, float u, float& local) {
+    int count = static_cast<int>(breakpoints.size()) - 1;
+    auto it = std::upper_bound(breakpoints.begin() + 1, breakpoints.end() - 1, u);
+    int k = std::min(static_cast<int>(it - breakpoints.begin()) - 1, count - 1);
+    float width = breakpoints[k + 1] - breakpoints[k];
+    local = width > 0.0f ? (u - breakpoints[k]) / width : 0.0f;
+    return k;
+}
+
+} // namespace
+
+// ========================
+// 1. Curve Extraction
+// ========================
+BezierCurveSegments extractBezierSegments(const std::vector<glm::vec3>& controlPoints,
+                                          const std::vector<float>& weights,
+                                          int degree) {
+    assert(weights.empty() || weights.size() == controlPoints.size());
+    BezierCurveSegments result;
+    int n = static_cast<int>(controlPoints.size());
+    if (degree >= n) degree = n - 1;
+    if (degree < 1) return result;
+
+    std::vector<glm::vec4> homogeneous(n);
+    for (int i = 0; i < n; ++i) {
+        float w = weights.empty() ? 1.0f : weights[i];
+        homogeneous[i] = glm::vec4(w * controlPoints[i], w);
+    }
+
+    auto knots = generateClampedKnotVector(n, degree);
+    result.degree = degree;
+    result.breakpoints = distinctBreakpoints(knots, n, degree);
+    decomposeCurve(n, degree, knots, homogeneous.data(), 1, result.points);
+
+    size_t count = result.segmentCount();
+    assert(result.points.size() == count * (degree + 1));
+    result.boundsMin.resize(count);
+    result.boundsMax.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        computeBounds(result.segment(k), degree + 1, result.boundsMin[k], result.boundsMax[k]);
+    }
+    return result;
+}
+
+// ========================
+// 2. Surface Extraction
+// ========================
+BezierSurfacePatches extractBezierPatches(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                                          const std::vector<std::vector<float>>& weights,
+                                          int degreeU, int degreeV) {
+    if (controlPoints.empty() || controlPoints[0].empty()) return {};
+    bool rational = !weights.empty();
+    if (rational && (weights.size() != controlPoints.size() || weights[0].size() != controlPoints[0].size())) {
+        return {}; // 权重和控制点维度必须一致
+    }
+    return extractBezierPatches(makeControlNet(controlPoints, weights), rational, degreeU, degreeV);
+}
+
+BezierSurfacePatches extractBezierPatches(const ControlNet& controlNet, bool rational, int degreeU, int degreeV) {
+    BezierSurfacePatches result;
+    int rows = controlNet.rows;
+    int cols = controlNet.cols;
+    if (rows < 2 || cols < 2) return result;
+    degreeU = std::max(1, std::min(degreeU, rows - 1));
+    degreeV = std::max(1, std::min(degreeV, cols - 1));
+
+    // 多项式曲面忽略网格中的权重：换成 w = 1 的副本
+    ControlNet polynomial;
+    if (!rational) {
+        polynomial = ControlNet(rows, cols);
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) polynomial.at(i, j) = glm::vec4(controlNet.point(i, j), 1.0f);
+        }
+    }
+    const ControlNet& net = rational ? controlNet : polynomial;
+
+    auto knotsU = generateClampedKnotVector(rows, degreeU);
+    auto knotsV = generateClampedKnotVector(cols, degreeV);
+    result.degreeU = degreeU;
+    result.degreeV = degreeV;
+    result.breakpointsU = distinctBreakpoints(knotsU, rows, degreeU);
+    result.breakpointsV = distinctBreakpoints(knotsV, cols, degreeV);
+    int patchesU = result.patchCountU();
+    int patchesV = result.patchCountV();
+    int orderU = degreeU + 1;
+    int orderV = degreeV + 1;
+
+    // 第一步：沿 u 分解每一列，得到 (patchesU·orderU) × cols 的中间网格
+    int midRows = patchesU * orderU;
+    std::vector<glm::vec4> mid(static_cast<size_t>(midRows) * cols);
+    std::vector<glm::vec4> column;
+    for (int j = 0; j < cols; ++j) {
+        column.clear();
+        decomposeCurve(rows, degreeU, knotsU, &net.at(0, j), net.rowStride, column);
+        for (int r = 0; r < midRows; ++r) mid[static_cast<size_t>(r) * cols + j] = column[r];
+    }
+
+    // 第二步：沿 v 分解中间网格的每一行，并按面片连续重排
+    result.points.resize(result.patchCount() * result.pointsPerPatch());
+    std::vector<glm::vec4> row;
+    for (int r = 0; r < midRows; ++r) {
+        row.clear();
+        decomposeCurve(cols, degreeV, knotsV, &mid[static_cast<size_t>(r) * cols], 1, row);
+        int pu = r / orderU;
+        int a = r % orderU;
+        for (int pv = 0; pv < patchesV; ++pv) {
+            glm::vec4* dst = &result.points[(static_cast<size_t>(pu) * patchesV + pv) * result.pointsPerPatch()];
+            std::copy(row.begin() + static_cast<size_t>(pv) * orderV,
+                      row.begin() + static_cast<size_t>(pv + 1) * orderV,
+                      dst + static_cast<size_t>(a) * orderV);
+        }
+    }
+
+    size_t count = result.patchCount();
+    result.boundsMin.resize(count);
+    result.boundsMax.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        computeBounds(result.patch(k), result.pointsPerPatch(), result.boundsMin[k], result.boundsMax[k]);
+    }
+    return result;
+}
+
+const BezierSurfacePatches& getBezierPatches(BezierPatchCache& cache, const ControlNet& net, bool rational,
+                                             int degreeU, int degreeV) {
+    // 多项式曲面不使用权重，权重修改不触发重新提取
+    uint64_t weightsGeneration = rational ? net.weightsGeneration.value : 0;
+    if (!cache.valid || cache.rows != net.rows || cache.cols != net.cols || cache.rational != rational ||
+        cache.degreeU != degreeU || cache.degreeV != degreeV ||
+        cache.pointsGeneration != net.pointsGeneration.value || cache.weightsGeneration != weightsGeneration) {
+        cache.patches = extractBezierPatches(net, rational, degreeU, degreeV);
+        cache.pointsGeneration = net.pointsGeneration.value;
+        cache.weightsGeneration = weightsGeneration;
+        cache.rows = net.rows;
+        cache.cols = net.cols;
+        cache.rational = rational;
+        cache.degreeU = degreeU;
+        cache.degreeV = degreeV;
+        cache.generation = nextGeneration();
+        cache.valid = true;
+    }
+    return cache.patches;
+}
+
+// ========================
+// 3. Tessellation from Bezier Form
+// ========================
+std::vector<glm::vec3> tessellateBezierSegments(const BezierCurveSegments& segments, int numSamples) {
+    std::vector<glm::vec3> curve;
+    if (segments.segmentCount() == 0 || numSamples < 1) return curve;
+
+    int order = segments.degree + 1;
+    std::vector<float> B(order);
+    curve.reserve(numSamples + 1);
+    for (int s = 0; s <= numSamples; ++s) {
+        float u = static_cast<float>(s) / numSamples;
+        float t;
+        int k = locateSegment(segments.breakpoints, u, t);
+        bernsteinBasis(segments.degree, t, B.data());
+        const glm::vec4* P = segments.segment(k);
+        glm::vec4 h(0.0f);
+        for (int a = 0; a < order; ++a) h += B[a] * P[a];
+        curve.push_back(projectPoint(h));
+    }
+    return curve;
+}
+
+std::vector<glm::vec3> tessellateBezierPatches(const BezierSurfacePatches& patches, int uSamples, int vSamples) {
+    std::vector<glm::vec3> surfacePoints;
+    if (patches.patchCount() == 0 || uSamples < 1 || vSamples < 1) return surfacePoints;
+
+    int orderU = patches.degreeU + 1;
+    int orderV = patches.degreeV + 1;
+
+    // 每个 v 采样所在面片列与伯恩斯坦基函数值只算一次
+    std::vector<int> patchV(vSamples + 1);
+    std::vector<float> Bv(static_cast<size_t>(vSamples + 1) * orderV);
+    for (int j = 0; j <= vSamples; ++j) {
+        float t;
+        patchV[j] = locateSegment(patches.breakpointsV, static_cast<float>(j) / vSamples, t);
+        bernsteinBasis(patches.degreeV, t, &Bv[static_cast<size_t>(j) * orderV]);
+    }
+
+    std::vector<float> Bu(orderU);
+    std::vector<glm::vec4> column(orderV);
+    surfacePoints.resize(static_cast<size_t>(uSamples + 1) * (vSamples + 1));
+    for (int i = 0; i <= uSamples; ++i) {
+        float t;
+        int pu = locateSegment(patches.breakpointsU, static_cast<float>(i) / uSamples, t);
+        bernsteinBasis(patches.degreeU, t, Bu.data());
+        int cachedPatch = -1;
+        for (int j = 0; j <= vSamples; ++j) {
+            int pv = patchV[j];
+            // 同一面片内先沿 u 收缩为 orderV 个点，再沿 v 求值
+            if (pv != cachedPatch) {
+                const glm::vec4* P = patches.patch(static_cast<size_t>(pu) * patches.patchCountV() + pv);
+                for (int b = 0; b < orderV; ++b) {
+                    glm::vec4 h(0.0f);
+                    for (int a = 0; a < orderU; ++a) h += Bu[a] * P[a * orderV + b];
+                    column[b] = h;
+                }
+                cachedPatch = pv;
+            }
+            const float* B = &Bv[static_cast<size_t>(j) * orderV];
+            glm::vec4 h(0.0f);
+            for (int b = 0; b < orderV; ++b) h += B[b] * column[b];
+            surfacePoints[static_cast<size_t>(i) * (vSamples + 1) + j] = projectPoint(h);
+        }
+    }
+    return surfacePoints;
+}
+
+} // namespace Spline
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "control_net.h"
+
+namespace Spline {
+
+// 钳位 B 样条 / NURBS 曲线的分段 Bezier 形式（Boehm 节点插入，将每个内部节点插满 p 重）。
+// 控制点为齐次坐标 (x·w, y·w, z·w, w)，多项式曲线的 w 恒为 1。
+struct BezierCurveSegments {
+    int degree = 0;
+    std::vector<float> breakpoints;     // segmentCount() + 1 个参数分界
+    std::vector<glm::vec4> points;      // 第 k 段为 points[k * (degree + 1) .. (k + 1) * (degree + 1))
+    std::vector<glm::vec3> boundsMin;   // 每段控制点（凸包）的包围盒，权重为正时包含该段曲线
+    std::vector<glm::vec3> boundsMax;
+
+    size_t segmentCount() const { return breakpoints.empty() ? 0 : breakpoints.size() - 1; }
+    const glm::vec4* segment(size_t k) const { return &points[k * (degree + 1)]; }
+};
+
+// 张量积曲面的 Bezier 面片形式，面片 (pu, pv) 的下标为 pu * patchCountV() + pv
+struct BezierSurfacePatches {
+    int degreeU = 0, degreeV = 0;
+    std::vector<float> breakpointsU, breakpointsV;
+    std::vector<glm::vec4> points;      // 面片连续存放，面片内 (degreeU + 1) × (degreeV + 1) 行优先
+    std::vector<glm::vec3> boundsMin;   // 每个面片的凸包包围盒
+    std::vector<glm::vec3> boundsMax;
+
+    int patchCountU() const { return breakpointsU.empty() ? 0 : static_cast<int>(breakpointsU.size()) - 1; }
+    int patchCountV() const { return breakpointsV.empty() ? 0 : static_cast<int>(breakpointsV.size()) - 1; }
+    size_t patchCount() const { return static_cast<size_t>(patchCountU()) * patchCountV(); }
+    size_t pointsPerPatch() const { return static_cast<size_t>(degreeU + 1) * (degreeV + 1); }
+    const glm::vec4* patch(size_t k) const { return &points[k * pointsPerPatch()]; }
+};
+
+// 与 evaluateBSpline / evaluateNURBS 相同的均匀钳位节点向量与次数截断；weights 为空时为多项式曲线
+BezierCurveSegments extractBezierSegments(const std::vector<glm::vec3>& controlPoints,
+                                          const std::vector<float>& weights,
+                                          int degree);
+
+// 与 evaluateBSplineSurface / evaluateNURBSSurface 相同的节点向量与次数截断；weights 为空时为多项式曲面
+BezierSurfacePatches extractBezierPatches(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                                          const std::vector<std::vector<float>>& weights,
+                                          int degreeU, int degreeV);
+// 直接读取齐次控制网格；rational = false 时忽略网格中的权重
+BezierSurfacePatches extractBezierPatches(const ControlNet& net, bool rational, int degreeU, int degreeV);
+
+// 直接由 Bezier 形式在任意分辨率下细分，输出布局与对应的 evaluate* 函数一致
+std::vector<glm::vec3> tessellateBezierSegments(const BezierCurveSegments& segments, int numSamples);
+std::vector<glm::vec3> tessellateBezierPatches(const BezierSurfacePatches& patches, int uSamples, int vSamples);
+
+// 按编辑缓存的面片形式：控制网格的修改计数、尺寸或次数变化时自动重新提取；
+// 绕过修改计数直接改写网格时调用 invalidate()
+struct BezierPatchCache {
+    BezierSurfacePatches patches;
+    bool valid = false;
+    bool rational = false;
+    int rows = 0, cols = 0;
+    int degreeU = 0, degreeV = 0;
+    uint64_t pointsGeneration = 0, weightsGeneration = 0;
+    uint64_t generation = 0; // 每次重新提取时取新值，依赖 patches 的派生数据（如面片 BVH）据此判断是否过期
+
+    void invalidate() { valid = false; }
+};
+
+const BezierSurfacePatches& getBezierPatches(BezierPatchCache& cache, const ControlNet& net, bool rational,
+                                             int degreeU, int degreeV);
+
+} // namespace Spline
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Spline {
+
+// 全局单调递增的修改计数来源：任意两次修改得到的值都不同。
+// 拷贝数据时计数随之拷贝，因此“计数相同”即可判定“内容未变”。
+inline uint64_t nextGeneration() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+// 被跟踪数据的修改计数：每次修改后调用 bump()
+struct Generation {
+    uint64_t value = nextGeneration();
+
+    void bump() { value = nextGeneration(); }
+};
+
+// 一次求值 / 上传所依赖的全部输入。消费者保存上次处理时的记录，与当前输入不同时才重新计算。
+// 非有理类型的 weights 填 0，权重变化不会触发重算。
+struct EvaluationStamp {
+    uint64_t points = 0;
+    uint64_t weights = 0;
+    int type = -1;
+    int degreeU = -1, degreeV = -1;
+    int uSamples = -1, vSamples = -1;
+
+    bool operator==(const EvaluationStamp& o) const {
+        return points == o.points && weights == o.weights && type == o.type &&
+               degreeU == o.degreeU && degreeV == o.degreeV &&
+               uSamples == o.uSamples && vSamples == o.vSamples;
+    }
+    bool operator!=(const EvaluationStamp& o) const { return !(*this == o); }
+};
+
+// 输入有变化时更新记录并返回 true
+inline bool updateStamp(EvaluationStamp& stored, const EvaluationStamp& current) {
+    if (stored == current) return false;
+    stored = current;
+    return true;
+}
+
+} // namespace Spline
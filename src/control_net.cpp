@@ -0,0 +1,42 @@
+#include "control_net.h"
+#include <cassert>
+
+namespace Spline {
+
+ControlNet makeControlNet(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                          const std::vector<std::vector<float>>& weights) {
+    if (controlPoints.empty() || controlPoints[0].empty()) return ControlNet();
+    int rows = static_cast<int>(controlPoints.size());
+    int cols = static_cast<int>(controlPoints[0].size());
+    assert(weights.empty() || weights.size() == controlPoints.size());
+
+    ControlNet net(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        assert(static_cast<int>(controlPoints[i].size()) == cols);
+        for (int j = 0; j < cols; ++j) {
+            float w = weights.empty() ? 1.0f : weights[i][j];
+            net.at(i, j) = glm::vec4(w * controlPoints[i][j], w);
+        }
+    }
+    return net;
+}
+
+std::vector<glm::vec3> controlNetPositions(const ControlNet& net) {
+    std::vector<glm::vec3> positions;
+    positions.reserve(net.size());
+    for (int i = 0; i < net.rows; ++i) {
+        for (int j = 0; j < net.cols; ++j) positions.push_back(net.point(i, j));
+    }
+    return positions;
+}
+
+std::vector<float> controlNetWeights(const ControlNet& net) {
+    std::vector<float> weights;
+    weights.reserve(net.size());
+    for (int i = 0; i < net.rows; ++i) {
+        for (int j = 0; j < net.cols; ++j) weights.push_back(net.weight(i, j));
+    }
+    return weights;
+}
+
+} // namespace Spline
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <glm/glm.hpp>
+#include "change_tracking.h"
+
+namespace Spline {
+
+// 步长视图：第 i 个元素为 data[i * stride]，用于访问控制网格的一行或一列
+template <typename T>
+struct StridedView {
+    T* data = nullptr;
+    size_t stride = 1;
+    int count = 0;
+
+    T& operator[](int i) const { return data[static_cast<size_t>(i) * stride]; }
+    int size() const { return count; }
+};
+
+// 曲面控制网格：单块连续内存，行优先存放齐次控制点 (x·w, y·w, z·w, w)。
+// 元素 (row, col) 位于 points[row * rowStride + col * colStride]；
+// 行方向（沿 v）步长为 1，求值内核和 GPU 上传都可以直接顺序访问。
+// setPoint / setWeight 会更新对应的修改计数；通过 at() 或 points 直接写入后需自行 bump()。
+struct ControlNet {
+    int rows = 0, cols = 0;
+    size_t rowStride = 0;
+    static constexpr size_t colStride = 1;
+    std::vector<glm::vec4> points;
+    Generation pointsGeneration;  // 笛卡尔位置
+    Generation weightsGeneration; // 权重
+
+    // 最近一次修改（位置或权重）的计数：计数全局递增，取两者较大者即可唯一标识当前内容
+    uint64_t generation() const { return std::max(pointsGeneration.value, weightsGeneration.value); }
+
+    ControlNet() = default;
+    ControlNet(int rows, int cols, const glm::vec4& fill = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f))
+        : rows(rows), cols(cols), rowStride(static_cast<size_t>(cols)),
+          points(static_cast<size_t>(rows) * cols, fill) {}
+
+    bool empty() const { return rows == 0 || cols == 0; }
+    size_t size() const { return points.size(); }
+    size_t index(int row, int col) const { return row * rowStride + col * colStride; }
+
+    glm::vec4& at(int row, int col) { return points[index(row, col)]; }
+    const glm::vec4& at(int row, int col) const { return points[index(row, col)]; }
+
+    // 笛卡尔坐标与权重（w 接近 0 时不做除法）
+    glm::vec3 point(int row, int col) const {
+        const glm::vec4& h = at(row, col);
+        return h.w != 0.0f ? glm::vec3(h) / h.w : glm::vec3(h);
+    }
+    float weight(int row, int col) const { return at(row, col).w; }
+
+    // 修改位置时保持权重不变，修改权重时保持位置不变
+    void setPoint(int row, int col, const glm::vec3& p) {
+        float w = weight(row, col);
+        at(row, col) = glm::vec4(w * p, w);
+        pointsGeneration.bump();
+    }
+    void setWeight(int row, int col, float w) {
+        glm::vec3 p = point(row, col);
+        at(row, col) = glm::vec4(w * p, w);
+        weightsGeneration.bump();
+    }
+
+    StridedView<glm::vec4> row(int r) { return {&points[index(r, 0)], colStride, cols}; }
+    StridedView<const glm::vec4> row(int r) const { return {&points[index(r, 0)], colStride, cols}; }
+    StridedView<glm::vec4> column(int c) { return {&points[index(0, c)], rowStride, rows}; }
+    StridedView<const glm::vec4> column(int c) const { return {&points[index(0, c)], rowStride, rows}; }
+};
+
+// 由二维控制点数组构建；weights 为空时权重全为 1
+ControlNet makeControlNet(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                          const std::vector<std::vector<float>>& weights = {});
+
+// 行优先的笛卡尔坐标与权重（用于旧接口或调试输出）
+std::vector<glm::vec3> controlNetPositions(const ControlNet& net);
+std::vector<float> controlNetWeights(const ControlNet& net);
+
+} // namespace Spline
@@ -0,0 +1,71 @@
+#include "frame_arena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace Spline {
+
+namespace {
+
+constexpr size_t kBufferAlignment = alignof(std::max_align_t);
+
+thread_local std::pmr::memory_resource* currentScratch = nullptr;
+
+} // namespace
+
+FrameArena::FrameArena(size_t capacity, std::pmr::memory_resource* upstream)
+    : upstream(upstream), size(capacity) {
+    if (size > 0) buffer = static_cast<std::byte*>(upstream->allocate(size, kBufferAlignment));
+}
+
+FrameArena::~FrameArena() {
+    for (const Block& block : overflow) upstream->deallocate(block.data, block.bytes, block.alignment);
+    if (buffer) upstream->deallocate(buffer, size, kBufferAlignment);
+}
+
+void FrameArena::reset() {
+    if (!overflow.empty()) {
+        for (const Block& block : overflow) upstream->deallocate(block.data, block.bytes, block.alignment);
+        overflow.clear();
+        overflowBytes = 0;
+
+        // 扩容到保守上界的下一个 2 的幂，下一帧起不再溢出
+        size_t grown = std::max<size_t>(size, 1024);
+        while (grown < growthTarget) grown *= 2;
+        if (buffer) upstream->deallocate(buffer, size, kBufferAlignment);
+        buffer = static_cast<std::byte*>(upstream->allocate(grown, kBufferAlignment));
+        size = grown;
+    }
+    offset = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    // 按实际地址对齐，支持大于 max_align_t 的对齐要求
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer);
+    std::uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    size_t begin = static_cast<size_t>(aligned - base);
+    if (buffer && begin + bytes <= size) {
+        offset = begin + bytes;
+        peak = std::max(peak, used());
+        return buffer + begin;
+    }
+
+    void* data = upstream->allocate(bytes, alignment);
+    overflow.push_back({data, bytes, alignment});
+    overflowBytes += bytes;
+    peak = std::max(peak, used());
+    // 扩容目标按整个主缓冲计入：对齐填充与主缓冲尾部的空隙也要放得下，保证扩容后整帧不再溢出
+    growthTarget = std::max(growthTarget, size + overflowBytes);
+    return data;
+}
+
+std::pmr::memory_resource* scratchResource() {
+    return currentScratch ? currentScratch : std::pmr::get_default_resource();
+}
+
+std::pmr::memory_resource* setScratchResource(std::pmr::memory_resource* resource) {
+    std::pmr::memory_resource* previous = scratchResource();
+    currentScratch = resource;
+    return previous;
+}
+
+} // namespace Spline
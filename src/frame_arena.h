@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace Spline {
+
+// 帧级线性分配器（pmr 接口）：分配只移动偏移量，deallocate 为空操作，
+// 帧末 reset() 一次性回收。容量不足时本帧向上游申请溢出块，reset() 时释放溢出块并把
+// 主缓冲扩到足以容纳整帧，之后的帧不再溢出，稳态下 reset() 为 O(1)。
+// 非线程安全：每个线程各用一个实例。
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t capacity = 256 * 1024,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 回收本帧全部分配；之前取得的指针全部失效
+    void reset();
+
+    size_t used() const { return offset + overflowBytes; } // 本帧已用字节（含溢出块）
+    size_t capacity() const { return size; }
+    size_t highWaterMark() const { return peak; }           // 创建以来单帧最大用量
+    size_t overflowCount() const { return overflow.size(); } // 本帧溢出块个数
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    struct Block {
+        void* data;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    std::pmr::memory_resource* upstream;
+    std::byte* buffer = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    std::vector<Block> overflow;
+    size_t overflowBytes = 0;
+    size_t peak = 0;         // 实际单帧用量的最大值
+    size_t growthTarget = 0; // 溢出时的保守上界（主缓冲全长 + 溢出块），只决定 reset() 的扩容大小
+};
+
+// 求值函数内部临时数组（节点向量、基函数缓冲等）的内存来源，按线程设置。
+// 默认为 std::pmr::get_default_resource()；主循环把帧级分配器装在这里。
+std::pmr::memory_resource* scratchResource();
+// 返回之前的来源；传入 nullptr 恢复默认
+std::pmr::memory_resource* setScratchResource(std::pmr::memory_resource* resource);
+
+} // namespace Spline
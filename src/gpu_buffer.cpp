@@ -0,0 +1,118 @@
+#include "gpu_buffer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace {
+
+typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+BufferStorageProc bufferStorage = nullptr;
+
+// 等待 fence 的单次超时（纳秒）；超时后继续等待，出错时放弃
+constexpr GLuint64 kFenceTimeout = 1000000;
+
+bool hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (ext && std::strcmp(ext, name) == 0) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+// ========================
+// 1. Capacity-Based Upload
+// ========================
+void uploadGrowing(unsigned int target, unsigned int buffer, size_t& capacity,
+                   const void* data, size_t bytes) {
+    glBindBuffer(target, buffer);
+    if (bytes > capacity) {
+        capacity = std::max(bytes, capacity * 2);
+        glBufferData(target, static_cast<GLsizeiptr>(capacity), nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (bytes > 0) glBufferSubData(target, 0, static_cast<GLsizeiptr>(bytes), data);
+}
+
+// ========================
+// 2. Persistent Mapped Ring
+// ========================
+bool loadBufferStorage(GLProcLoader loader) {
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool core = major > 4 || (major == 4 && minor >= 4);
+    if (!core && !hasExtension("GL_ARB_buffer_storage")) return false;
+    bufferStorage = reinterpret_cast<BufferStorageProc>(loader("glBufferStorage"));
+    return bufferStorage != nullptr;
+}
+
+bool bufferStorageAvailable() {
+    return bufferStorage != nullptr;
+}
+
+StreamRingBuffer::~StreamRingBuffer() {
+    destroy();
+}
+
+bool StreamRingBuffer::create(size_t bytes) {
+    destroy();
+    if (!bufferStorage || bytes == 0) return false;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr total = static_cast<GLsizeiptr>(bytes * kSegments);
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    bufferStorage(GL_ARRAY_BUFFER, total, nullptr, flags);
+    mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags));
+    if (!mapped) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+        return false;
+    }
+    segmentBytes = bytes;
+    current = kSegments - 1; // 第一次 beginWrite 写第 0 段
+    return true;
+}
+
+void StreamRingBuffer::destroy() {
+    if (!buffer) return;
+    for (int s = 0; s < kSegments; ++s) waitSegment(s);
+    // 删除缓冲区时映射随之解除
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+    mapped = nullptr;
+    segmentBytes = 0;
+    current = 0;
+}
+
+void* StreamRingBuffer::beginWrite() {
+    if (!mapped) return nullptr;
+    current = (current + 1) % kSegments;
+    waitSegment(current);
+    return mapped + drawOffset();
+}
+
+void StreamRingBuffer::fence() {
+    if (!buffer) return;
+    if (fences[current]) glDeleteSync(fences[current]);
+    fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamRingBuffer::waitSegment(int segment) {
+    GLsync sync = fences[segment];
+    if (!sync) return;
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(sync, waitFlags, kFenceTimeout) == GL_TIMEOUT_EXPIRED) waitFlags = 0;
+    glDeleteSync(sync);
+    fences[segment] = nullptr;
+}
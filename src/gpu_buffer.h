@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+
+// ========================
+// 1. 按容量增长的上传
+// ========================
+// 数据量不超过 capacity 时只做 glBufferSubData，不重新分配驱动端存储；
+// 超过时按 2 倍增长重新分配。capacity 为调用方为该缓冲区保存的当前容量（字节）。
+// 调用前后 target 上绑定的都是 buffer。
+void uploadGrowing(unsigned int target, unsigned int buffer, size_t& capacity,
+                   const void* data, size_t bytes);
+
+// ========================
+// 2. 持久映射流式缓冲区
+// ========================
+// 生成的 glad 只包含 GL 3.3 core，glBufferStorage 需要运行时单独加载：
+// 上下文版本 >= 4.4 或支持 GL_ARB_buffer_storage 时返回 true。
+using GLProcLoader = void* (*)(const char* name);
+bool loadBufferStorage(GLProcLoader loader);
+bool bufferStorageAvailable();
+
+// 三段环形缓冲区：整块存储用 glBufferStorage 持久、一致映射，每次写入使用下一段，
+// 写入前等待该段上次被绘制时插入的 fence，CPU 不会覆盖 GPU 仍在读取的数据，
+// 也不会因 glBufferData / glBufferSubData 的隐式同步而停顿。
+// 用法：ptr = beginWrite() → 直接写入（求值函数的输出指针）→ 以 drawOffset() 绘制 → 本帧绘制命令之后 fence()。
+class StreamRingBuffer {
+public:
+    static constexpr int kSegments = 3;
+
+    StreamRingBuffer() = default;
+    ~StreamRingBuffer();
+
+    StreamRingBuffer(const StreamRingBuffer&) = delete;
+    StreamRingBuffer& operator=(const StreamRingBuffer&) = delete;
+
+    // 需要 bufferStorageAvailable()；失败返回 false
+    bool create(size_t segmentBytes);
+    // 等待全部 fence 后释放
+    void destroy();
+
+    bool valid() const { return buffer != 0; }
+    unsigned int id() const { return buffer; }
+    size_t segmentSize() const { return segmentBytes; }
+
+    // 前进到下一段并返回其映射地址，可写 segmentSize() 字节
+    void* beginWrite();
+    // 最近一次 beginWrite 所写段在缓冲区中的字节偏移
+    size_t drawOffset() const { return static_cast<size_t>(current) * segmentBytes; }
+    // 为当前段插入 fence：在所有读取当前段的绘制命令之后调用（每帧一次）
+    void fence();
+
+private:
+    void waitSegment(int segment);
+
+    unsigned int buffer = 0;
+    size_t segmentBytes = 0;
+    unsigned char* mapped = nullptr;
+    int current = 0;
+    struct __GLsync* fences[kSegments] = {};
+};
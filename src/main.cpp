@@ -5,10 +5,21 @@
 #include <backends/imgui_impl_opengl3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <vector>
 #include <iostream>
+#include <cstdio>
 
 #include "spline.h"
+#include "stencil.h"
+#include "power_basis.h"
+#include "surface_topology.h"
+#include "point_bvh.h"
+#include "point_grid.h"
+#include "surface_raycast.h"
+#include "point_projection.h"
+#include "frame_arena.h"
+#include "change_tracking.h"
 #include "renderer.h"
 #include "camera.h"
 
@@ -18,12 +29,75 @@ bool isShowControlPoints = true;
 std::vector<glm::vec3> controlPoints;
 std::vector<float> weights; // 每个控制点的权重
 int curveType = 0; // 0: Bezier, 1: B-spline, 2: NURBS
-std::vector<std::vector<glm::vec3>> surfaceControlPoints;
-std::vector<std::vector<float>> surfaceWeights;
+Spline::Generation curvePointsGeneration;  // 修改 controlPoints 后 bump()
+Spline::Generation curveWeightsGeneration; // 修改 weights 后 bump()
+Spline::Generation curveVerticesGeneration; // 重新求值 curveVertices 后 bump()
+Spline::ControlNet surfaceNet; // 曲面控制网格（齐次坐标，行优先连续存放）
 int surfaceType = 0;
 
+// 求值模板：拓扑/次数/采样数不变时复用，拖拽时只做稀疏加权求和
+Spline::EvaluationStencil curveStencil;
+Spline::EvaluationStencil surfaceStencil;
+// 控制点较少而采样密集时曲线改用逐段幂基多项式求值，转换结果按修改计数缓存
+Spline::PowerBasisCache curvePowerBasis;
+
+// 曲面细分缓存：单点编辑只修补局部支撑内的采样点并局部上传
+struct SurfaceEdit {
+    int row, col;
+    glm::vec3 oldPoint, newPoint;
+    float oldWeight, newWeight;
+};
+Spline::SurfaceTessellation surfaceMesh;
+std::vector<SurfaceEdit> surfaceEdits; // 本帧待应用的编辑
+bool surfaceMeshValid = false;         // false 时下一帧全量重建
+int surfaceMeshType = -1;              // 生成 surfaceMesh 时的曲面类型
+
+// 上次求值 / 上传时的输入记录：输入未变的帧跳过求值和上传
+Spline::EvaluationStamp curveStamp;
+Spline::EvaluationStamp surfaceStamp;
+
+// 逐帧复用的输出缓冲区：只 resize/clear，容量保留，稳态帧不再分配
+std::vector<glm::vec3> curveVertices;
+
+// 曲面索引拓扑按采样数缓存，采样数不变时不再生成或上传
+Spline::SurfaceTopologyCache surfaceTopologies;
+Spline::IndexLayout surfaceIndexLayout = Spline::IndexLayout::TriangleStrips;
+SurfaceRenderMode surfaceRenderMode = SurfaceRenderMode::Shaded;
+int isoLineSpacing = 5; // 等参线间隔（采样格数）
+
+// 控制点拾取 BVH：控制网格 pointsGeneration 变化时重建，拖拽时只做增量 refit
+Spline::PointBVH surfaceNetBVH;
+uint64_t surfaceNetBVHGeneration = 0;
+
+// 2D 控制点拾取网格：curvePointsGeneration 在别处（清空、删除）变化时重建，增点 / 拖拽时增量维护
+Spline::PointGrid2D curvePointGrid;
+uint64_t curvePointGridGeneration = 0;
+std::vector<int> selectedCurvePoints; // Shift + 拖拽框选的控制点下标（升序）
+bool boxSelecting = false;
+glm::vec2 boxStart, boxEnd;           // 框选矩形的两个角（NDC）
+
+// GPU ID 缓冲拾取：启用时 3D 悬停改用最近一次异步回读的结果（晚 1～2 帧），而不是射线与球求交
+bool useGpuPicking = false;
+PickResult gpuPick;
+
+// 光标下的曲面点：面片形式与面片 BVH 按控制网格的修改计数缓存，曲面不变时每次只做遍历和 Newton 迭代
+Spline::SurfaceRaycastCache surfaceRaycast;
+Spline::SurfaceHit surfaceHit;
+bool surfaceHitValid = false;
+
+// 光标在 2D 曲线上的最近点：Bezier 段与段 BVH 按曲线输入缓存，输入不变时每次只做遍历和 Newton 迭代
+Spline::BezierCurveSegments curveSegments;
+Spline::PatchBVH curveSegmentBVH;
+Spline::EvaluationStamp curveSegmentStamp;
+Spline::CurveProjection curveHover;
+bool curveHoverValid = false;
+
+// 帧级临时内存：ImGui 标签及求值函数内部临时数组都从这里取，帧末统一回收
+Spline::FrameArena frameArena;
+
 bool dragging = false;
 int draggedIndex = -1;
+bool wasDeletePressed = false;
 
 int windowWidth = 1024;
 int windowHeight = 768;
@@ -65,43 +139,115 @@ glm::vec3 screenToNDC(double x, double y, int width, int height) {
 void handle2DMouseInteraction(GLFWwindow* window, 
                               std::vector<glm::vec3>& controlPoints,
                               std::vector<float>& weights,
+                              Spline::Generation& pointsGeneration,
+                              Spline::Generation& weightsGeneration,
                               bool& dragging, int& draggedIndex,
                               int width, int height) {
     static bool wasPressed = false;
     bool isPressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    constexpr float pickRadius = 0.05f;
+
+    if (curvePointGrid.size() != controlPoints.size() || curvePointGridGeneration != pointsGeneration.value) {
+        Spline::buildPointGrid(curvePointGrid, controlPoints.data(), controlPoints.size(), pickRadius);
+        curvePointGridGeneration = pointsGeneration.value;
+        selectedCurvePoints.clear();
+    }
 
     if (isPressed && !wasPressed) {
         double x, y;
         glfwGetCursorPos(window, &x, &y);
-        glm::vec3 worldPt = screenToNDC(x, y, width, height);
-
-        bool found = false;
-        for (size_t i = 0; i < controlPoints.size(); ++i) {
-            glm::vec2 p(controlPoints[i].x, controlPoints[i].y);
-            glm::vec2 click(worldPt.x, worldPt.y);
-            if (glm::distance(p, click) < 0.05f) {
+        glm::vec2 click(screenToNDC(x, y, width, height));
+        bool shift = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+                     glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
+
+        if (shift) {
+            // Shift + 拖拽：框选
+            boxSelecting = true;
+            boxStart = boxEnd = click;
+        } else {
+            // 重叠时取最近的点
+            int hit = Spline::findNearestGridPoint(curvePointGrid, click, pickRadius);
+            if (hit != -1) {
                 dragging = true;
-                draggedIndex = static_cast<int>(i);
-                found = true;
-                break;
+                draggedIndex = hit;
+            } else {
+                controlPoints.push_back(glm::vec3(click, 0.0f));
+                weights.push_back(1.0f);
+                pointsGeneration.bump();
+                weightsGeneration.bump();
+                Spline::appendGridPoint(curvePointGrid, click);
+                curvePointGridGeneration = pointsGeneration.value;
             }
         }
-        if (!found) {
-            controlPoints.push_back(worldPt);
-            weights.push_back(1.0f);
-        }
     } else if (!isPressed && wasPressed) {
+        if (boxSelecting) {
+            Spline::queryGridRect(curvePointGrid, glm::min(boxStart, boxEnd), glm::max(boxStart, boxEnd),
+                                  selectedCurvePoints);
+            boxSelecting = false;
+        }
         dragging = false;
         draggedIndex = -1;
     }
     wasPressed = isPressed;
 
+    if (boxSelecting) {
+        double x, y;
+        glfwGetCursorPos(window, &x, &y);
+        boxEnd = glm::vec2(screenToNDC(x, y, width, height));
+    }
+
     if (dragging && draggedIndex != -1) {
         double x, y;
         glfwGetCursorPos(window, &x, &y);
         glm::vec3 worldPt = screenToNDC(x, y, width, height);
-        controlPoints[draggedIndex] = worldPt;
+        if (controlPoints[draggedIndex] != worldPt) {
+            controlPoints[draggedIndex] = worldPt;
+            pointsGeneration.bump();
+            Spline::moveGridPoint(curvePointGrid, draggedIndex, glm::vec2(worldPt));
+            curvePointGridGeneration = pointsGeneration.value;
+        }
+    }
+}
+
+// 删除框选的控制点（selectedCurvePoints 为升序下标），其余点保持原有顺序
+void eraseSelectedCurvePoints(std::vector<glm::vec3>& controlPoints, std::vector<float>& weights) {
+    size_t keep = 0, s = 0;
+    for (size_t i = 0; i < controlPoints.size(); ++i) {
+        if (s < selectedCurvePoints.size() && selectedCurvePoints[s] == static_cast<int>(i)) {
+            ++s;
+            continue;
+        }
+        controlPoints[keep] = controlPoints[i];
+        if (i < weights.size()) weights[keep] = weights[i];
+        ++keep;
     }
+    controlPoints.resize(keep);
+    weights.resize(std::min(weights.size(), keep));
+    selectedCurvePoints.clear();
+}
+
+// 光标到曲线的最近点（拖拽控制点时不计算）
+void updateCurveHover(GLFWwindow* window, int width, int height) {
+    constexpr float hoverDistance = 0.05f;
+    curveHoverValid = false;
+    int n = static_cast<int>(controlPoints.size());
+    if (dragging || n < 2) return;
+
+    // 与曲线求值相同的次数
+    int degree = curveType == 0 ? n - 1 : 3;
+    bool rational = curveType == 2 && weights.size() == controlPoints.size();
+    Spline::EvaluationStamp inputs{curvePointsGeneration.value, rational ? curveWeightsGeneration.value : 0,
+                                   curveType, degree, -1, -1, -1};
+    if (Spline::updateStamp(curveSegmentStamp, inputs)) {
+        curveSegments = Spline::extractBezierSegments(controlPoints, rational ? weights : std::vector<float>(), degree);
+        Spline::buildPatchBVH(curveSegmentBVH, curveSegments);
+    }
+
+    double mouseX, mouseY;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+    glm::vec3 cursor = screenToNDC(mouseX, mouseY, width, height);
+    Spline::projectPointsToCurve(curveSegments, curveSegmentBVH, &cursor, 1, &curveHover, 1);
+    curveHoverValid = curveHover.segment >= 0 && curveHover.distance < hoverDistance;
 }
 
 // 将屏幕坐标 (x, y) 转换为世界空间射线（起点 + 方向）
@@ -168,7 +314,7 @@ bool rayIntersectYZPlane(const glm::vec3& rayOrigin, const glm::vec3& rayDir,
 void handle3DSurfaceInteraction(GLFWwindow* window,
                                Camera& camera,
                                const ImGuiIO& io,
-                               std::vector<std::vector<glm::vec3>>& surfaceControlPoints,
+                               Spline::ControlNet& surfaceNet,
                                int& hovered3DIndex,
                                int& selected3DIndex,
                                bool& isZEditMode,
@@ -189,26 +335,31 @@ void handle3DSurfaceInteraction(GLFWwindow* window,
     glm::mat4 view = camera.getViewMatrix();
     auto [rayOrigin, rayDir] = screenToWorldRay(mouseX, mouseY, windowWidth, windowHeight, view, proj);
 
-    // 将二维网格转换为一维索引来处理
-    std::vector<glm::vec3> flatControlPoints;
-    std::vector<std::pair<int, int>> indexMap; // 映射一维索引到二维坐标
-    
-    for (int i = 0; i < static_cast<int>(surfaceControlPoints.size()); ++i) {
-        for (int j = 0; j < static_cast<int>(surfaceControlPoints[i].size()); ++j) {
-            flatControlPoints.push_back(surfaceControlPoints[i][j]);
-            indexMap.emplace_back(i, j);
-        }
-    }
+    // 控制点一维索引即网格行优先下标 row * cols + col
 
     // === 1. 更新悬停状态（每帧）===
-    hovered3DIndex = -1;
     constexpr float hoverRadius = 0.12f;
-    for (size_t i = 0; i < flatControlPoints.size(); ++i) {
-        float t;
-        if (rayIntersectsSphere(rayOrigin, rayDir, flatControlPoints[i], hoverRadius, t)) {
-            hovered3DIndex = static_cast<int>(i);
-            break;
+    if (useGpuPicking) {
+        bool hit = gpuPick.kind == PickResult::Kind::ControlPoint &&
+                   gpuPick.index < static_cast<int>(surfaceNet.size());
+        hovered3DIndex = hit ? gpuPick.index : -1;
+    } else {
+        // 点在屏幕上重叠时取沿射线最近的点
+        if (surfaceNetBVH.size() != surfaceNet.size() || surfaceNetBVHGeneration != surfaceNet.pointsGeneration.value) {
+            Spline::buildPointBVH(surfaceNetBVH, surfaceNet);
+            surfaceNetBVHGeneration = surfaceNet.pointsGeneration.value;
         }
+        hovered3DIndex = Spline::pickNearestPoint(surfaceNetBVH, rayOrigin, rayDir, hoverRadius);
+    }
+
+    // 悬停在控制点上或拖拽时不求交（拖拽中每帧都要重新提取面片）
+    surfaceHitValid = false;
+    if (hovered3DIndex == -1 && !isDraggingPoint && !surfaceNet.empty()) {
+        // 与曲面求值相同的次数
+        int degreeU = surfaceType == 0 ? surfaceNet.rows - 1 : 3;
+        int degreeV = surfaceType == 0 ? surfaceNet.cols - 1 : 3;
+        surfaceHitValid = Spline::raycastSurface(surfaceRaycast, surfaceNet, surfaceType == 2, degreeU, degreeV,
+                                                 rayOrigin, rayDir, surfaceHit);
     }
 
     // === 2. 鼠标按下事件（左键）===
@@ -226,6 +377,11 @@ void handle3DSurfaceInteraction(GLFWwindow* window,
 
     // === 3. 鼠标释放 ===
     if (!isPressed && wasPressed && isShowControlPoints) {
+        // 拖拽结束后全量重建一次，消除增量累加的浮点误差；BVH 也重建以恢复紧凑的划分
+        if (isDraggingPoint) {
+            surfaceMeshValid = false;
+            surfaceNetBVHGeneration = 0;
+        }
         isDraggingPoint = false;
         selected3DIndex = -1;
     }
@@ -235,24 +391,35 @@ void handle3DSurfaceInteraction(GLFWwindow* window,
     }
 
     // === 4. 拖拽更新 ===
-    if (isPressed && isDraggingPoint && selected3DIndex != -1 && selected3DIndex < static_cast<int>(indexMap.size()) && isShowControlPoints) {
+    if (isPressed && isDraggingPoint && selected3DIndex != -1 && selected3DIndex < static_cast<int>(surfaceNet.size()) && isShowControlPoints) {
         // 将一维索引转换回二维坐标
-        auto [row, col] = indexMap[selected3DIndex];
+        int row = selected3DIndex / surfaceNet.cols;
+        int col = selected3DIndex % surfaceNet.cols;
+        glm::vec3 oldPoint = surfaceNet.point(row, col);
+        glm::vec3 newPoint = oldPoint;
         
         if (isZEditMode) {
             // Z 轴模式
             glm::vec3 hit;
-            if (rayIntersectYZPlane(rayOrigin, rayDir, surfaceControlPoints[row][col].x, hit)) {
-                surfaceControlPoints[row][col].z = hit.z;
+            if (rayIntersectYZPlane(rayOrigin, rayDir, oldPoint.x, hit)) {
+                newPoint.z = hit.z;
             }
         } else {
             // XOY 平面模式
             glm::vec3 hit;
-            if (rayIntersectXOYPlane(rayOrigin, rayDir, surfaceControlPoints[row][col].z, hit)) {
-                surfaceControlPoints[row][col].x = hit.x;
-                surfaceControlPoints[row][col].y = hit.y;
+            if (rayIntersectXOYPlane(rayOrigin, rayDir, oldPoint.z, hit)) {
+                newPoint.x = hit.x;
+                newPoint.y = hit.y;
             }
         }
+
+        if (newPoint != oldPoint) {
+            surfaceNet.setPoint(row, col, newPoint);
+            float w = surfaceNet.weight(row, col);
+            surfaceEdits.push_back({row, col, oldPoint, newPoint, w, w});
+            Spline::refitPointBVH(surfaceNetBVH, selected3DIndex, newPoint);
+            surfaceNetBVHGeneration = surfaceNet.pointsGeneration.value;
+        }
     }
 
     // === 5. 相机交互：仅当未拖拽点时 ===
@@ -332,6 +499,8 @@ int main() {
     // 创建渲染器
     Renderer renderer;
     renderer.setOrtho(-1.0f, 1.0f, -1.0f, 1.0f); // NDC 空间
+    // 有 GL 4.4 / ARB_buffer_storage 时曲线和曲面顶点走持久映射的环形缓冲区
+    renderer.enableStreaming((GLProcLoader)glfwGetProcAddress);
 
     // 启用深度测试
     glEnable(GL_DEPTH_TEST);
@@ -345,11 +514,8 @@ int main() {
     );
 
     // 预生成初始4x4控制点网格按钮
-    std::vector<std::vector<glm::vec3>> initial_surfaceControlPoints;
-    std::vector<std::vector<float>> initial_surfaceWeights;
+    Spline::ControlNet initial_surfaceNet(4, 4);
     for (int i = 0; i < 4; ++i) {
-        std::vector<glm::vec3> row;
-        std::vector<float> weightRow;
         for (int j = 0; j < 4; ++j) {
             // 生成网格状分布的控制点
             glm::vec3 point(
@@ -357,19 +523,21 @@ int main() {
                 (static_cast<float>(j) - 1.5f) * 0.5f,  // y坐标
                 (sin(static_cast<float>(i)) + cos(static_cast<float>(j))) * 0.3f  // z坐标，形成波浪形状
             );
-            row.push_back(point);
-            weightRow.push_back(1.0f);
+            initial_surfaceNet.at(i, j) = glm::vec4(point, 1.0f);
         }
-        initial_surfaceControlPoints.push_back(row);
-        initial_surfaceWeights.push_back(weightRow);
     }
-    surfaceControlPoints = initial_surfaceControlPoints;
-    surfaceWeights = initial_surfaceWeights;
+    surfaceNet = initial_surfaceNet;
+
+    Spline::setScratchResource(&frameArena);
 
     // 主循环
     while (!glfwWindowShouldClose(window)) {
+        frameArena.reset();
         glfwPollEvents();
 
+        PickResult pick;
+        if (renderer.pollPick(pick)) gpuPick = pick;
+
         // 设置view、projection矩阵
         if(enable3DView) {
             renderer.setViewMatrix(camera.getViewMatrix());
@@ -395,55 +563,97 @@ int main() {
         ImGuiIO& io = ImGui::GetIO();
 
         // === 处理画布鼠标事件 ===
+        curveHoverValid = false;
         if (!io.WantCaptureMouse) {
             if (enable3DView) {
-                handle3DSurfaceInteraction(window, camera, io, surfaceControlPoints,
+                handle3DSurfaceInteraction(window, camera, io, surfaceNet,
                                     hovered3DIndex, selected3DIndex, isZEditMode, isDraggingPoint,
                                     windowWidth, windowHeight);
             } else {
-                handle2DMouseInteraction(window, controlPoints, weights, dragging, draggedIndex, windowWidth, windowHeight);
+                handle2DMouseInteraction(window, controlPoints, weights, curvePointsGeneration, curveWeightsGeneration, dragging, draggedIndex, windowWidth, windowHeight);
+                updateCurveHover(window, windowWidth, windowHeight);
             }
         }
 
-        // Delete 键（同样检查 WantCaptureKeyboard）
-        if (!io.WantCaptureKeyboard && glfwGetKey(window, GLFW_KEY_DELETE) == GLFW_PRESS) {
-            controlPoints.clear();
-            weights.clear();
+        // Delete 键（同样检查 WantCaptureKeyboard）：有框选时只删除选中的点，否则全部清空
+        bool deletePressed = !io.WantCaptureKeyboard && glfwGetKey(window, GLFW_KEY_DELETE) == GLFW_PRESS;
+        if (deletePressed && !wasDeletePressed && !controlPoints.empty()) {
+            if (!selectedCurvePoints.empty()) {
+                eraseSelectedCurvePoints(controlPoints, weights);
+            } else {
+                controlPoints.clear();
+                weights.clear();
+            }
+            curvePointsGeneration.bump();
+            curveWeightsGeneration.bump();
         }
+        wasDeletePressed = deletePressed;
 
         // UI 控制面板
         {
             ImGui::Begin("Spline Control");
             ImGui::Checkbox("Enable 3D View", &enable3DView);
+            ImGui::Text("Frame arena: peak %.1f KB / %.1f KB",
+                        frameArena.highWaterMark() / 1024.0, frameArena.capacity() / 1024.0);
             if (enable3DView) {
 
                 const char* surfaceTypes[] = {"Bezier Surface", "B-spline Surface", "NURBS Surface"};
                 ImGui::Combo("Surface Type", &surfaceType, surfaceTypes, 3);
 
-                ImGui::Text("Surface Control Points: %dx%d", 
-                        surfaceControlPoints.size(), 
-                        surfaceControlPoints.empty() ? 0 : surfaceControlPoints[0].size());
+                const char* indexLayouts[] = {"Triangles", "Cache-Optimized Triangles", "Triangle Strips"};
+                int layout = static_cast<int>(surfaceIndexLayout);
+                if (ImGui::Combo("Index Layout", &layout, indexLayouts, 3)) {
+                    surfaceIndexLayout = static_cast<Spline::IndexLayout>(layout);
+                }
+
+                const char* renderModes[] = {"Shaded", "Wireframe", "Iso-lines"};
+                int mode = static_cast<int>(surfaceRenderMode);
+                if (ImGui::Combo("Surface Display", &mode, renderModes, 3)) {
+                    surfaceRenderMode = static_cast<SurfaceRenderMode>(mode);
+                }
+                if (surfaceRenderMode == SurfaceRenderMode::IsoLines) {
+                    ImGui::SliderInt("Iso-line Spacing", &isoLineSpacing, 1, 15);
+                }
+
+                ImGui::Text("Surface Control Points: %dx%d", surfaceNet.rows, surfaceNet.cols);
                 
                 ImGui::Text("Drag Mode: %s", isZEditMode ? "Z-axis" : "XY-plane");
+                if (surfaceHitValid) {
+                    ImGui::Text("Surface hit: (u, v) = (%.3f, %.3f)", surfaceHit.uv.x, surfaceHit.uv.y);
+                    ImGui::Text("  at (%.3f, %.3f, %.3f)", surfaceHit.point.x, surfaceHit.point.y, surfaceHit.point.z);
+                }
+
+                if (renderer.idPickingAvailable()) {
+                    ImGui::Checkbox("GPU Picking (ID buffer)", &useGpuPicking);
+                    if (useGpuPicking && gpuPick.kind == PickResult::Kind::Surface) {
+                        ImGui::Text("Surface (u, v): %.3f, %.3f", gpuPick.uv.x, gpuPick.uv.y);
+                    }
+                }
 
                 // 与isShowControlPoints绑定
                 ImGui::Checkbox("Show Control Points", &isShowControlPoints);
                 
                 if (ImGui::Button("Reset Surface")) {
-                    surfaceControlPoints.clear();
-                    surfaceWeights.clear();
-                    surfaceControlPoints = initial_surfaceControlPoints;
-                    surfaceWeights = initial_surfaceWeights;
+                    surfaceNet = initial_surfaceNet;
+                    surfaceEdits.clear();
+                    surfaceMeshValid = false;
                 }
                 
                 // 显示权重调整（仅NURBS）
-                if (surfaceType == 2 && !surfaceControlPoints.empty()) {
+                if (surfaceType == 2 && !surfaceNet.empty()) {
                     ImGui::Separator();
                     ImGui::Text("Weights:");
-                    for (size_t i = 0; i < surfaceControlPoints.size(); ++i) {
-                        for (size_t j = 0; j < surfaceControlPoints[i].size(); ++j) {
-                            std::string label = "w[" + std::to_string(i) + "][" + std::to_string(j) + "]";
-                            ImGui::DragFloat(label.c_str(), &surfaceWeights[i][j], 0.05f, 0.01f, 10.0f);
+                    for (int i = 0; i < surfaceNet.rows; ++i) {
+                        for (int j = 0; j < surfaceNet.cols; ++j) {
+                            char* label = static_cast<char*>(frameArena.allocate(24, 1));
+                            std::snprintf(label, 24, "w[%d][%d]", i, j);
+                            float oldWeight = surfaceNet.weight(i, j);
+                            float newWeight = oldWeight;
+                            if (ImGui::DragFloat(label, &newWeight, 0.05f, 0.01f, 10.0f) && newWeight != oldWeight) {
+                                glm::vec3 p = surfaceNet.point(i, j);
+                                surfaceNet.setWeight(i, j, newWeight);
+                                surfaceEdits.push_back({i, j, p, p, oldWeight, newWeight});
+                            }
                         }
                     }
                 }
@@ -452,101 +662,137 @@ int main() {
                 const char* types[] = {"Bezier", "B-spline", "NURBS"};
                 ImGui::Combo("Curve Type", &curveType, types, 3);
                 ImGui::Text("Control Points: %d", (int)controlPoints.size());
+                if (!selectedCurvePoints.empty()) {
+                    ImGui::Text("Selected: %d (Delete to remove)", (int)selectedCurvePoints.size());
+                }
+                if (curveHoverValid) {
+                    ImGui::Text("Curve: u = %.3f, distance = %.4f", curveHover.u, curveHover.distance);
+                }
                 if (ImGui::Button("Clear All")) {
                     controlPoints.clear();
                     weights.clear();
+                    selectedCurvePoints.clear();
+                    curvePointsGeneration.bump();
+                    curveWeightsGeneration.bump();
                 }
                 if (curveType == 2 && !controlPoints.empty()) { // 仅在 NURBS 模式下显示
                     ImGui::Separator();
                     ImGui::Text("Weights:");
                     for (size_t i = 0; i < controlPoints.size(); ++i) {
-                        std::string label = "w[" + std::to_string(i) + "]";
+                        char* label = static_cast<char*>(frameArena.allocate(16, 1));
+                        std::snprintf(label, 16, "w[%zu]", i);
                         // 使用 DragFloat 允许用户拖动调整（范围 0.1 ~ 10.0，可自定义）
-                        ImGui::DragFloat(label.c_str(), &weights[i], 0.05f, 0.01f, 10.0f);
+                        if (ImGui::DragFloat(label, &weights[i], 0.05f, 0.01f, 10.0f)) {
+                            curveWeightsGeneration.bump();
+                        }
                     }
                 }
             }
             ImGui::End();
         }
 
-        std::vector<glm::vec3> surfaceVertices;
-        std::vector<unsigned int> surfaceIndices;
-
-        if (enable3DView && !surfaceControlPoints.empty()) {
+        if (enable3DView && !surfaceNet.empty()) {
             // 计算曲面
             int uSamples = 30;
             int vSamples = 30;
-            
-            if (!surfaceControlPoints.empty() && !surfaceControlPoints[0].empty()) {
-                if (surfaceType == 0) {
-                    // Bezier Surface
-                    surfaceVertices = Spline::evaluateBezierSurface(surfaceControlPoints, uSamples, vSamples);
-                } else if (surfaceType == 1) {
-                    // B-spline Surface
-                    surfaceVertices = Spline::evaluateBSplineSurface(surfaceControlPoints, 3, 3, uSamples, vSamples);
-                } else if (surfaceType == 2) {
-                    // NURBS Surface
-                    surfaceVertices = Spline::evaluateNURBSSurface(surfaceControlPoints, surfaceWeights, 3, 3, uSamples, vSamples);
+
+            int rows = surfaceNet.rows;
+            int cols = surfaceNet.cols;
+            // Bezier 曲面即次数为 (控制点数 - 1) 的钳位 B 样条曲面
+            int degreeU = surfaceType == 0 ? rows - 1 : 3;
+            int degreeV = surfaceType == 0 ? cols - 1 : 3;
+            // Bezier / B 样条不使用权重，权重修改不触发重算
+            Spline::EvaluationStamp surfaceInputs{surfaceNet.pointsGeneration.value,
+                                                  surfaceType == 2 ? surfaceNet.weightsGeneration.value : 0,
+                                                  surfaceType, degreeU, degreeV, uSamples, vSamples};
+            bool surfaceChanged = Spline::updateStamp(surfaceStamp, surfaceInputs);
+            bool rebuilt = surfaceChanged &&
+                           Spline::updateSurfaceStencil(surfaceStencil, rows, cols, degreeU, degreeV, uSamples, vSamples);
+
+            if (!surfaceChanged && surfaceMeshValid) {
+                // 输入未变：沿用上一帧的细分结果和 GPU 缓冲区
+            } else if (rebuilt || !surfaceMeshValid || surfaceMeshType != surfaceType) {
+                // Bezier / B 样条忽略网格中保存的 NURBS 权重
+                Spline::rebuildTessellation(surfaceMesh, surfaceStencil, surfaceNet, surfaceType == 2);
+                renderer.updateSurface(surfaceMesh.positions, surfaceMesh.generation.value);
+                surfaceMeshValid = true;
+                surfaceMeshType = surfaceType;
+            } else if (!surfaceEdits.empty()) {
+                for (const auto& e : surfaceEdits) {
+                    float oldWeight = surfaceType == 2 ? e.oldWeight : 1.0f;
+                    float newWeight = surfaceType == 2 ? e.newWeight : 1.0f;
+                    Spline::updateTessellationPoint(surfaceMesh, surfaceStencil, e.row, e.col,
+                                                    e.oldPoint, oldWeight, e.newPoint, newWeight);
                 }
-                
-                // 生成索引
-                surfaceIndices = Spline::generateSurfaceIndices(uSamples, vSamples);
+                renderer.updateSurfaceRange(surfaceMesh.positions, vSamples + 1,
+                                            surfaceMesh.dirtyUBegin, surfaceMesh.dirtyUEnd,
+                                            surfaceMesh.dirtyVBegin, surfaceMesh.dirtyVEnd,
+                                            surfaceMesh.generation.value);
             }
-            
-            // 将曲面控制点展平为一维数组用于渲染
-            std::vector<glm::vec3> flatControlPoints;
-            for (const auto& row : surfaceControlPoints) {
-                for (const auto& point : row) {
-                    flatControlPoints.push_back(point);
-                }
+            Spline::clearTessellationDirty(surfaceMesh);
+            // 拓扑已上传时为 O(1) 比较
+            renderer.setSurfaceTopology(
+                Spline::getSurfaceTopology(surfaceTopologies, uSamples, vSamples, surfaceIndexLayout));
+            renderer.setSurfaceRenderMode(surfaceRenderMode);
+            if (surfaceRenderMode != SurfaceRenderMode::Shaded) {
+                // 线框即间隔为 1 的等参线
+                int stride = surfaceRenderMode == SurfaceRenderMode::Wireframe ? 1 : isoLineSpacing;
+                renderer.setSurfaceLineTopology(Spline::getSurfaceTopology(
+                    surfaceTopologies, uSamples, vSamples, Spline::IndexLayout::GridLines, stride));
             }
+            surfaceEdits.clear();
 
-            // 生成控制网格线框数据
-            std::vector<glm::vec3> controlWireframeLines;
-            int rows = static_cast<int>(surfaceControlPoints.size());
-            int cols = static_cast<int>(surfaceControlPoints[0].size());
-
-            // 生成横向线段
-            for (int i = 0; i < rows; ++i) {
-                for (int j = 0; j < cols - 1; ++j) {
-                    controlWireframeLines.push_back(surfaceControlPoints[i][j]);
-                    controlWireframeLines.push_back(surfaceControlPoints[i][j + 1]);
-                }
+            // 控制网格只在控制点或权重变化时重新上传；线框为引用同一批控制点的静态索引，按网格尺寸缓存
+            renderer.updateControlNet(surfaceNet);
+            renderer.setControlNetTopology(
+                Spline::getSurfaceTopology(surfaceTopologies, rows - 1, cols - 1, Spline::IndexLayout::GridLines));
+        } else {
+            // 确保 weights 长度匹配（安全起见）
+            if (weights.size() != controlPoints.size()) {
+                weights.assign(controlPoints.size(), 1.0f);
+                curveWeightsGeneration.bump();
             }
-            
-            // 生成纵向线段
-            for (int j = 0; j < cols; ++j) {
-                for (int i = 0; i < rows - 1; ++i) {
-                    controlWireframeLines.push_back(surfaceControlPoints[i][j]);
-                    controlWireframeLines.push_back(surfaceControlPoints[i + 1][j]);
+            int n = static_cast<int>(controlPoints.size());
+            int curveDegree = curveType == 0 ? n - 1 : 3;
+            const int curveSamples = 100;
+            Spline::EvaluationStamp curveInputs{curvePointsGeneration.value,
+                                                curveType == 2 ? curveWeightsGeneration.value : 0,
+                                                curveType, curveDegree, -1, curveSamples, -1};
+            if (Spline::updateStamp(curveStamp, curveInputs)) {
+                // 原有的曲线计算逻辑
+                size_t count = 0;
+                if (!controlPoints.empty()) {
+                    Spline::updateCurveStencil(curveStencil, n, curveDegree, curveSamples);
+                    count = curveStencil.vertexCount();
                 }
-            }
-            
-            renderer.updateControlPoints(flatControlPoints);
-            renderer.updateSurface(surfaceVertices, surfaceIndices);
-            renderer.updateWireframe(controlWireframeLines);
-        } else {
-            // 原有的曲线计算逻辑
-            std::vector<glm::vec3> curve;
-            if (!controlPoints.empty()) {
-                if (curveType == 0) {
-                    curve = Spline::evaluateBezier(controlPoints, 100);
-                } else if (curveType == 1) {
-                    curve = Spline::evaluateBSpline(controlPoints, 3, 100);
-                } else if (curveType == 2) {
-                    // 为每个控制点分配权重（默认 1.0）
-                    // 确保 weights 长度匹配（安全起见）
-                    if (weights.size() != controlPoints.size()) {
-                        weights.assign(controlPoints.size(), 1.0f);
+                // 支持持久映射时求值结果直接写入 GPU 可见内存，否则写入 curveVertices 再上传
+                glm::vec3* mapped = renderer.beginCurveWrite(count);
+                if (!mapped) curveVertices.resize(count);
+                glm::vec3* out = mapped ? mapped : curveVertices.data();
+                if (count > 0 && Spline::shouldUsePowerBasis(n, std::min(curveDegree, n - 1), curveSamples)) {
+                    if (curveType == 2) {
+                        Spline::evaluateNURBS(controlPoints, weights, curveDegree, curveSamples, curvePowerBasis,
+                                              curvePointsGeneration.value, curveWeightsGeneration.value, out, count);
+                    } else {
+                        Spline::evaluateBSpline(controlPoints, curveDegree, curveSamples, curvePowerBasis,
+                                                curvePointsGeneration.value, out, count);
                     }
-                    curve = Spline::evaluateNURBS(controlPoints, weights, 3, 100);
+                } else if (count > 0 && curveType == 2) {
+                    Spline::applyStencilRational(curveStencil, controlPoints, weights, out, count);
+                } else if (count > 0) {
+                    Spline::applyStencil(curveStencil, controlPoints, out, count);
+                }
+                curveVerticesGeneration.bump();
+
+                // 更新渲染器数据
+                renderer.updateControlPoints(controlPoints, curvePointsGeneration.value);
+                renderer.updateControlPolygon(controlPoints, curvePointsGeneration.value);
+                if (mapped) {
+                    renderer.commitCurve(count, curveVerticesGeneration.value);
+                } else {
+                    renderer.updateCurve(curveVertices, curveVerticesGeneration.value);
                 }
             }
-
-            // 更新渲染器数据
-            renderer.updateControlPoints(controlPoints);
-            renderer.updateControlPolygon(controlPoints);
-            renderer.updateCurve(curve);
         }
 
         // 渲染
@@ -561,11 +807,37 @@ int main() {
                 renderer.renderWireframe();
             }
             renderer.renderSurface();
-            
+
+            if (useGpuPicking) {
+                double mouseX, mouseY;
+                glfwGetCursorPos(window, &mouseX, &mouseY);
+                renderer.requestPick(static_cast<int>(mouseX), static_cast<int>(mouseY),
+                                     windowWidth, windowHeight, true);
+            }
         } else {
             renderer.render();
         }
 
+        renderer.endFrame();
+
+        // 框选矩形、选中的点与光标下的曲线点（NDC → 窗口像素）
+        if (!enable3DView && (boxSelecting || !selectedCurvePoints.empty() || curveHoverValid)) {
+            ImDrawList* overlay = ImGui::GetForegroundDrawList();
+            auto toScreen = [](const glm::vec2& p) {
+                return ImVec2((p.x + 1.0f) * 0.5f * windowWidth, (1.0f - p.y) * 0.5f * windowHeight);
+            };
+            const ImU32 selectionColor = IM_COL32(255, 200, 0, 255);
+            if (boxSelecting) overlay->AddRect(toScreen(boxStart), toScreen(boxEnd), selectionColor);
+            for (int i : selectedCurvePoints) {
+                if (i < static_cast<int>(controlPoints.size())) {
+                    overlay->AddCircle(toScreen(glm::vec2(controlPoints[i])), 6.0f, selectionColor);
+                }
+            }
+            if (curveHoverValid) {
+                overlay->AddCircleFilled(toScreen(glm::vec2(curveHover.point)), 4.0f, IM_COL32(0, 200, 255, 255));
+            }
+        }
+
         // 渲染 ImGui
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -0,0 +1,141 @@
+#include "pick_buffer.h"
+#include <glad/glad.h>
+#include <cstring>
+
+namespace {
+
+// PBO 内布局：[0, 4) 为 ID，[8, 16) 为 (u, v)
+constexpr size_t kIdOffset = 0;
+constexpr size_t kUVOffset = 8;
+constexpr size_t kSlotBytes = 16;
+
+} // namespace
+
+PickBuffer::~PickBuffer() {
+    destroy();
+}
+
+bool PickBuffer::resize(int newWidth, int newHeight) {
+    if (newWidth <= 0 || newHeight <= 0) return false;
+    if (fbo && newWidth == width && newHeight == height) return true;
+    if (!fbo) {
+        glGenFramebuffers(1, &fbo);
+        glGenTextures(1, &idTexture);
+        glGenTextures(1, &uvTexture);
+        glGenRenderbuffers(1, &depthBuffer);
+        glGenBuffers(kSlots, pbos);
+        for (int s = 0; s < kSlots; ++s) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[s]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, kSlotBytes, nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    width = newWidth;
+    height = newHeight;
+
+    auto allocate = [&](unsigned int texture, GLenum internalFormat, GLenum format, GLenum type) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    };
+    allocate(idTexture, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT);
+    allocate(uvTexture, GL_RG32F, GL_RG, GL_FLOAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, idTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, uvTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) destroy();
+    return complete;
+}
+
+void PickBuffer::destroy() {
+    if (!fbo) return;
+    for (int s = 0; s < kSlots; ++s) {
+        if (fences[s]) glDeleteSync(fences[s]);
+        fences[s] = nullptr;
+    }
+    glDeleteBuffers(kSlots, pbos);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteTextures(1, &uvTexture);
+    glDeleteTextures(1, &idTexture);
+    glDeleteFramebuffers(1, &fbo);
+    fbo = idTexture = uvTexture = depthBuffer = 0;
+    std::memset(pbos, 0, sizeof(pbos));
+    width = height = 0;
+    next = pending = 0;
+}
+
+bool PickBuffer::begin(int x, int y) {
+    if (!fbo || x < 0 || y < 0 || x >= width || y >= height) return false;
+    currentX = x;
+    currentY = y;
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, height - 1 - y, 1, 1);
+    const GLuint noId[4] = {0, 0, 0, 0};
+    const GLfloat noUV[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const GLfloat farDepth = 1.0f;
+    glClearBufferuiv(GL_COLOR, 0, noId);
+    glClearBufferfv(GL_COLOR, 1, noUV);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+    return true;
+}
+
+void PickBuffer::end() {
+    // 槽都在途时丢弃最旧的结果
+    if (pending == kSlots) --pending;
+    if (fences[next]) glDeleteSync(fences[next]);
+
+    int y = height - 1 - currentY;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[next]);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(currentX, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, reinterpret_cast<void*>(kIdOffset));
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glReadPixels(currentX, y, 1, 1, GL_RG, GL_FLOAT, reinterpret_cast<void*>(kUVOffset));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    fences[next] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pixelX[next] = currentX;
+    pixelY[next] = currentY;
+    next = (next + 1) % kSlots;
+    ++pending;
+
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool PickBuffer::poll(PickSample& out) {
+    bool found = false;
+    while (pending > 0) {
+        int slot = (next - pending + kSlots) % kSlots;
+        // 超时为 0：只查询状态。第一次查询带 FLUSH 标志，保证 fence 最终会被提交
+        GLenum status = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        glDeleteSync(fences[slot]);
+        fences[slot] = nullptr;
+        --pending;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+        if (const unsigned char* data = static_cast<const unsigned char*>(
+                glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, kSlotBytes, GL_MAP_READ_BIT))) {
+            std::memcpy(&out.id, data + kIdOffset, sizeof(out.id));
+            std::memcpy(&out.uv, data + kUVOffset, sizeof(out.uv));
+            out.x = pixelX[slot];
+            out.y = pixelY[slot];
+            found = true;
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    return found;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// 拾取缓冲读出的一个像素：ID 为 0 表示没有物体
+struct PickSample {
+    unsigned int id = 0;
+    glm::vec2 uv = glm::vec2(0.0f);
+    int x = 0, y = 0; // 请求时的像素坐标（左上角为原点）
+};
+
+// 离屏 ID 缓冲：附件 0 为 R32UI 物体 ID，附件 1 为 RG32F 曲面参数，另带深度缓冲以处理遮挡。
+// 每次拾取只清除并光栅化光标下的一个像素（剪裁测试），再用 glReadPixels 把该像素读进 PBO；
+// 读取在 GPU 上排队，CPU 之后几帧用 fence 检查完成再映射 PBO，全程不等待 GPU。
+class PickBuffer {
+public:
+    static constexpr int kSlots = 3; // 同时在途的回读数，超出时丢弃最旧的一次
+
+    PickBuffer() = default;
+    ~PickBuffer();
+
+    PickBuffer(const PickBuffer&) = delete;
+    PickBuffer& operator=(const PickBuffer&) = delete;
+
+    // 尺寸变化时重建附件；帧缓冲不完整时返回 false
+    bool resize(int width, int height);
+    void destroy();
+    bool valid() const { return fbo != 0; }
+
+    // 绑定 ID 帧缓冲，视口设为整个缓冲区，剪裁到像素 (x, y)（左上角为原点）并清除该像素。
+    // 返回 false 表示坐标在缓冲区外，此时不做任何绑定
+    bool begin(int x, int y);
+    // 把 begin 的像素排队读进下一个 PBO，恢复默认帧缓冲并关闭剪裁测试
+    void end();
+
+    // 取出已完成的回读：有新结果时写入 out（多个完成时取最新的）并返回 true，从不阻塞
+    bool poll(PickSample& out);
+
+private:
+    unsigned int fbo = 0, idTexture = 0, uvTexture = 0, depthBuffer = 0;
+    int width = 0, height = 0;
+
+    unsigned int pbos[kSlots] = {};
+    struct __GLsync* fences[kSlots] = {};
+    int pixelX[kSlots] = {}, pixelY[kSlots] = {};
+    int next = 0;    // 下一次回读写入的槽
+    int pending = 0; // 在途回读数，最旧的位于 next - pending
+    int currentX = 0, currentY = 0;
+};
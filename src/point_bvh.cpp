@@ -0,0 +1,254 @@
+#include "point_bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPLINE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Spline {
+
+namespace {
+
+// 遍历栈深度上限：中位数划分的树高约为 log2(n / kBvhLeafSize)
+constexpr int kMaxTraversalDepth = 64;
+
+void computeBounds(PointBVH& bvh, const glm::vec3* points, int nodeIndex, int begin, int end) {
+    glm::vec3 lo = points[bvh.order[begin]];
+    glm::vec3 hi = lo;
+    for (int k = begin + 1; k < end; ++k) {
+        lo = glm::min(lo, points[bvh.order[k]]);
+        hi = glm::max(hi, points[bvh.order[k]]);
+    }
+    bvh.nodes[nodeIndex].boundsMin = lo;
+    bvh.nodes[nodeIndex].boundsMax = hi;
+}
+
+// 沿包围盒最长轴按中位数划分
+void buildNode(PointBVH& bvh, const glm::vec3* points, int nodeIndex, int begin, int end) {
+    computeBounds(bvh, points, nodeIndex, begin, end);
+    if (end - begin <= kBvhLeafSize) {
+        bvh.nodes[nodeIndex].first = begin;
+        bvh.nodes[nodeIndex].count = end - begin;
+        return;
+    }
+
+    glm::vec3 extent = bvh.nodes[nodeIndex].boundsMax - bvh.nodes[nodeIndex].boundsMin;
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(bvh.order.begin() + begin, bvh.order.begin() + mid, bvh.order.begin() + end,
+                     [&](int a, int b) { return points[a][axis] < points[b][axis]; });
+
+    int left = static_cast<int>(bvh.nodes.size());
+    bvh.nodes.resize(bvh.nodes.size() + 2);
+    bvh.nodes[left].parent = nodeIndex;
+    bvh.nodes[left + 1].parent = nodeIndex;
+    bvh.nodes[nodeIndex].first = left;
+    bvh.nodes[nodeIndex].count = 0;
+    buildNode(bvh, points, left, begin, mid);
+    buildNode(bvh, points, left + 1, mid, end);
+}
+
+// 射线与（按 radius 扩大的）包围盒的进入参数；不相交或整段在 tMax 之后时返回 +inf
+float intersectBounds(const PointBVH::Node& node, const glm::vec3& origin, const glm::vec3& invDir,
+                      float radius, float tMax) {
+    glm::vec3 t0 = (node.boundsMin - glm::vec3(radius) - origin) * invDir;
+    glm::vec3 t1 = (node.boundsMax + glm::vec3(radius) - origin) * invDir;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+    return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+}
+
+struct RayQuery {
+    glm::vec3 origin, dir;
+    float a;        // dot(dir, dir)
+    float radius2;
+};
+
+// 与 rayIntersectsSphere 相同的近交点公式：t = (-b - sqrt(b² - a·c)) / a，b = dot(oc, dir)
+void testPointsScalar(const PointBVH& bvh, const RayQuery& ray, int begin, int end, float& bestT, int& best) {
+    for (int s = begin; s < end; ++s) {
+        glm::vec3 oc = ray.origin - glm::vec3(bvh.x[s], bvh.y[s], bvh.z[s]);
+        float b = glm::dot(oc, ray.dir);
+        float c = glm::dot(oc, oc) - ray.radius2;
+        float disc = b * b - ray.a * c;
+        if (disc < 0.0f) continue;
+        float t = (-b - std::sqrt(disc)) / ray.a;
+        if (t >= 0.0f && t < bestT) {
+            bestT = t;
+            best = s;
+        }
+    }
+}
+
+#ifdef SPLINE_SIMD_X86
+
+// SSE2：一次检测 4 个点，尾部走标量
+__attribute__((target("sse2")))
+void testLeaf(const PointBVH& bvh, const RayQuery& ray, int begin, int end, float& bestT, int& best) {
+    const __m128 ox = _mm_set1_ps(ray.origin.x), oy = _mm_set1_ps(ray.origin.y), oz = _mm_set1_ps(ray.origin.z);
+    const __m128 dx = _mm_set1_ps(ray.dir.x), dy = _mm_set1_ps(ray.dir.y), dz = _mm_set1_ps(ray.dir.z);
+    const __m128 a = _mm_set1_ps(ray.a);
+    const __m128 r2 = _mm_set1_ps(ray.radius2);
+    const __m128 zero = _mm_setzero_ps();
+
+    int s = begin;
+    for (; s + 4 <= end; s += 4) {
+        __m128 ocx = _mm_sub_ps(ox, _mm_loadu_ps(&bvh.x[s]));
+        __m128 ocy = _mm_sub_ps(oy, _mm_loadu_ps(&bvh.y[s]));
+        __m128 ocz = _mm_sub_ps(oz, _mm_loadu_ps(&bvh.z[s]));
+        __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, dx), _mm_mul_ps(ocy, dy)), _mm_mul_ps(ocz, dz));
+        __m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ocx), _mm_mul_ps(ocy, ocy)),
+                                         _mm_mul_ps(ocz, ocz)), r2);
+        __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+        __m128 hit = _mm_cmpge_ps(disc, zero);
+        if (_mm_movemask_ps(hit) == 0) continue;
+
+        __m128 t = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero, b), _mm_sqrt_ps(_mm_max_ps(disc, zero))), a);
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(bestT))));
+        int mask = _mm_movemask_ps(hit);
+        if (mask == 0) continue;
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, t);
+        for (int k = 0; k < 4; ++k) {
+            if ((mask & (1 << k)) && lanes[k] < bestT) {
+                bestT = lanes[k];
+                best = s + k;
+            }
+        }
+    }
+    testPointsScalar(bvh, ray, s, end, bestT, best);
+}
+
+#else
+
+void testLeaf(const PointBVH& bvh, const RayQuery& ray, int begin, int end, float& bestT, int& best) {
+    testPointsScalar(bvh, ray, begin, end, bestT, best);
+}
+
+#endif
+
+} // namespace
+
+// ========================
+// 1. Build & Refit
+// ========================
+void buildPointBVH(PointBVH& bvh, const glm::vec3* points, size_t count) {
+    bvh.nodes.clear();
+    bvh.order.resize(count);
+    for (size_t i = 0; i < count; ++i) bvh.order[i] = static_cast<int>(i);
+    bvh.slotOf.resize(count);
+    bvh.leafOf.resize(count);
+    bvh.x.resize(count);
+    bvh.y.resize(count);
+    bvh.z.resize(count);
+    if (count == 0) return;
+
+    bvh.nodes.reserve(2 * (count / kBvhLeafSize + 1));
+    bvh.nodes.emplace_back();
+    buildNode(bvh, points, 0, 0, static_cast<int>(count));
+
+    for (size_t n = 0; n < bvh.nodes.size(); ++n) {
+        const PointBVH::Node& node = bvh.nodes[n];
+        for (int s = node.first; s < node.first + node.count; ++s) bvh.leafOf[bvh.order[s]] = static_cast<int>(n);
+    }
+    for (size_t s = 0; s < count; ++s) {
+        int i = bvh.order[s];
+        bvh.slotOf[i] = static_cast<int>(s);
+        bvh.x[s] = points[i].x;
+        bvh.y[s] = points[i].y;
+        bvh.z[s] = points[i].z;
+    }
+}
+
+void buildPointBVH(PointBVH& bvh, const ControlNet& net) {
+    std::vector<glm::vec3> points(net.size());
+    for (int i = 0; i < net.rows; ++i) {
+        for (int j = 0; j < net.cols; ++j) points[net.index(i, j)] = net.point(i, j);
+    }
+    buildPointBVH(bvh, points.data(), points.size());
+}
+
+void refitPointBVH(PointBVH& bvh, int index, const glm::vec3& position) {
+    if (index < 0 || index >= static_cast<int>(bvh.size())) return;
+    int slot = bvh.slotOf[index];
+    bvh.x[slot] = position.x;
+    bvh.y[slot] = position.y;
+    bvh.z[slot] = position.z;
+
+    // 叶子包围盒从其点重新计算，祖先取两个子节点的并集
+    int n = bvh.leafOf[index];
+    PointBVH::Node& leaf = bvh.nodes[n];
+    glm::vec3 lo(bvh.x[leaf.first], bvh.y[leaf.first], bvh.z[leaf.first]);
+    glm::vec3 hi = lo;
+    for (int s = leaf.first + 1; s < leaf.first + leaf.count; ++s) {
+        glm::vec3 p(bvh.x[s], bvh.y[s], bvh.z[s]);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    leaf.boundsMin = lo;
+    leaf.boundsMax = hi;
+
+    for (n = leaf.parent; n >= 0; n = bvh.nodes[n].parent) {
+        PointBVH::Node& node = bvh.nodes[n];
+        const PointBVH::Node& l = bvh.nodes[node.first];
+        const PointBVH::Node& r = bvh.nodes[node.first + 1];
+        glm::vec3 newMin = glm::min(l.boundsMin, r.boundsMin);
+        glm::vec3 newMax = glm::max(l.boundsMax, r.boundsMax);
+        if (newMin == node.boundsMin && newMax == node.boundsMax) break; // 上层不受影响
+        node.boundsMin = newMin;
+        node.boundsMax = newMax;
+    }
+}
+
+// ========================
+// 2. Ray Query
+// ========================
+int pickNearestPoint(const PointBVH& bvh, const glm::vec3& origin, const glm::vec3& dir,
+                     float radius, float* hitT) {
+    if (bvh.empty()) return -1;
+    RayQuery ray{origin, dir, glm::dot(dir, dir), radius * radius};
+    if (ray.a <= 0.0f) return -1;
+    glm::vec3 invDir = 1.0f / dir;
+
+    float bestT = std::numeric_limits<float>::infinity();
+    int bestSlot = -1;
+
+    struct Entry {
+        int node;
+        float tEnter;
+    };
+    Entry stack[kMaxTraversalDepth];
+    int top = 0;
+    float rootT = intersectBounds(bvh.nodes[0], origin, invDir, radius, bestT);
+    if (rootT == std::numeric_limits<float>::infinity()) return -1;
+    stack[top++] = {0, rootT};
+
+    while (top > 0) {
+        Entry e = stack[--top];
+        if (e.tEnter > bestT) continue; // 已有更近的命中
+        const PointBVH::Node& node = bvh.nodes[e.node];
+        if (node.count > 0) {
+            testLeaf(bvh, ray, node.first, node.first + node.count, bestT, bestSlot);
+            continue;
+        }
+        // 近的子节点后入栈、先出栈
+        float tl = intersectBounds(bvh.nodes[node.first], origin, invDir, radius, bestT);
+        float tr = intersectBounds(bvh.nodes[node.first + 1], origin, invDir, radius, bestT);
+        Entry l{node.first, tl}, r{node.first + 1, tr};
+        if (tl > tr) std::swap(l, r);
+        if (r.tEnter != std::numeric_limits<float>::infinity() && top < kMaxTraversalDepth) stack[top++] = r;
+        if (l.tEnter != std::numeric_limits<float>::infinity() && top < kMaxTraversalDepth) stack[top++] = l;
+    }
+
+    if (bestSlot < 0) return -1;
+    if (hitT) *hitT = bestT;
+    return bvh.order[bestSlot];
+}
+
+} // namespace Spline
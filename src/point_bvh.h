@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "control_net.h"
+
+namespace Spline {
+
+// 叶子最多包含的点数（两组 4 路 SIMD 检测）
+constexpr int kBvhLeafSize = 8;
+
+// 控制点包围体层次，用于射线拾取：每个点视为半径 radius 的球，查询返回沿射线最近的命中点。
+// 点坐标按叶子顺序以 SoA 存放，叶子内一次检测 4 个点。
+// 控制点移动后用 refitPointBVH 只更新所在叶子及其祖先的包围盒；拓扑不变，移动幅度很大时应重建。
+struct PointBVH {
+    struct Node {
+        glm::vec3 boundsMin = glm::vec3(0.0f); // 点的包围盒（不含球半径）
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+        int first = 0;  // 叶子：在 order 中的起始位置；内部节点：左子节点下标（右子节点为 first + 1）
+        int count = 0;  // 叶子的点数，内部节点为 0
+        int parent = -1;
+    };
+
+    std::vector<Node> nodes;     // nodes[0] 为根
+    std::vector<int> order;      // 叶子顺序下第 k 个位置对应的点下标
+    std::vector<int> slotOf;     // 点下标 → 在 order 中的位置
+    std::vector<int> leafOf;     // 点下标 → 所在叶子节点
+    std::vector<float> x, y, z;  // 按 order 排列的坐标
+
+    size_t size() const { return order.size(); }
+    bool empty() const { return order.empty(); }
+};
+
+void buildPointBVH(PointBVH& bvh, const glm::vec3* points, size_t count);
+// 使用控制网格的笛卡尔坐标，点下标即行优先下标 row * cols + col
+void buildPointBVH(PointBVH& bvh, const ControlNet& net);
+
+// 点 index 移动到 position：O(叶子大小 + 树高)
+void refitPointBVH(PointBVH& bvh, int index, const glm::vec3& position);
+
+// 射线 origin + t·dir（t >= 0）与各点半径 radius 的球求交，返回近交点 t 最小的点下标，未命中返回 -1。
+// 与逐点 rayIntersectsSphere 的判定一致：起点在球内（近交点 t < 0）不算命中
+int pickNearestPoint(const PointBVH& bvh, const glm::vec3& origin, const glm::vec3& dir,
+                     float radius, float* hitT = nullptr);
+
+} // namespace Spline
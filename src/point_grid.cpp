@@ -0,0 +1,136 @@
+#include "point_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Spline {
+
+namespace {
+
+// 格子坐标限制在 ±2^30，避免极端坐标在 floor 后溢出 int32
+constexpr float kMaxCellCoord = 1073741824.0f;
+
+int32_t cellCoord(float v, float cellSize) {
+    float c = std::floor(v / cellSize);
+    return static_cast<int32_t>(std::clamp(c, -kMaxCellCoord, kMaxCellCoord));
+}
+
+uint64_t cellKey(int32_t cx, int32_t cy) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+}
+
+int32_t keyX(uint64_t key) { return static_cast<int32_t>(static_cast<uint32_t>(key >> 32)); }
+int32_t keyY(uint64_t key) { return static_cast<int32_t>(static_cast<uint32_t>(key)); }
+
+uint64_t cellKeyOf(const PointGrid2D& grid, const glm::vec2& p) {
+    return cellKey(cellCoord(p.x, grid.cellSize), cellCoord(p.y, grid.cellSize));
+}
+
+// 对格子范围 [cx0, cx1] × [cy0, cy1] 内的每个非空桶调用 fn；
+// 范围内的格子比非空桶还多时（大矩形），改为遍历所有桶再按坐标过滤
+template <typename Fn>
+void forEachCell(const PointGrid2D& grid, int32_t cx0, int32_t cy0, int32_t cx1, int32_t cy1, Fn&& fn) {
+    int64_t span = (static_cast<int64_t>(cx1) - cx0 + 1) * (static_cast<int64_t>(cy1) - cy0 + 1);
+    if (span > static_cast<int64_t>(grid.cells.size())) {
+        for (const auto& [key, bucket] : grid.cells) {
+            int32_t cx = keyX(key), cy = keyY(key);
+            if (cx >= cx0 && cx <= cx1 && cy >= cy0 && cy <= cy1) fn(bucket);
+        }
+        return;
+    }
+    for (int32_t cx = cx0; cx <= cx1; ++cx) {
+        for (int32_t cy = cy0; cy <= cy1; ++cy) {
+            auto it = grid.cells.find(cellKey(cx, cy));
+            if (it != grid.cells.end()) fn(it->second);
+        }
+    }
+}
+
+void removeFromBucket(PointGrid2D& grid, uint64_t key, int index) {
+    auto it = grid.cells.find(key);
+    if (it == grid.cells.end()) return;
+    std::vector<int>& bucket = it->second;
+    auto pos = std::find(bucket.begin(), bucket.end(), index);
+    if (pos != bucket.end()) {
+        *pos = bucket.back();
+        bucket.pop_back();
+    }
+    if (bucket.empty()) grid.cells.erase(it);
+}
+
+} // namespace
+
+// ========================
+// 1. Maintenance
+// ========================
+void buildPointGrid(PointGrid2D& grid, const glm::vec3* points, size_t count, float cellSize) {
+    clearPointGrid(grid);
+    if (cellSize > 0.0f) grid.cellSize = cellSize;
+    grid.positions.reserve(count);
+    grid.cellOf.reserve(count);
+    for (size_t i = 0; i < count; ++i) appendGridPoint(grid, glm::vec2(points[i]));
+}
+
+void clearPointGrid(PointGrid2D& grid) {
+    grid.cells.clear();
+    grid.positions.clear();
+    grid.cellOf.clear();
+}
+
+void appendGridPoint(PointGrid2D& grid, const glm::vec2& position) {
+    int index = static_cast<int>(grid.positions.size());
+    uint64_t key = cellKeyOf(grid, position);
+    grid.positions.push_back(position);
+    grid.cellOf.push_back(key);
+    grid.cells[key].push_back(index);
+}
+
+void moveGridPoint(PointGrid2D& grid, int index, const glm::vec2& position) {
+    if (index < 0 || index >= static_cast<int>(grid.size())) return;
+    grid.positions[index] = position;
+    uint64_t key = cellKeyOf(grid, position);
+    if (key == grid.cellOf[index]) return;
+    removeFromBucket(grid, grid.cellOf[index], index);
+    grid.cellOf[index] = key;
+    grid.cells[key].push_back(index);
+}
+
+// ========================
+// 2. Queries
+// ========================
+int findNearestGridPoint(const PointGrid2D& grid, const glm::vec2& position, float radius) {
+    if (grid.empty() || !(radius > 0.0f)) return -1;
+    float bestDist2 = radius * radius;
+    int best = -1;
+    forEachCell(grid,
+                cellCoord(position.x - radius, grid.cellSize), cellCoord(position.y - radius, grid.cellSize),
+                cellCoord(position.x + radius, grid.cellSize), cellCoord(position.y + radius, grid.cellSize),
+                [&](const std::vector<int>& bucket) {
+                    for (int i : bucket) {
+                        glm::vec2 d = grid.positions[i] - position;
+                        float dist2 = glm::dot(d, d);
+                        if (dist2 < bestDist2 || (dist2 == bestDist2 && best >= 0 && i < best)) {
+                            bestDist2 = dist2;
+                            best = i;
+                        }
+                    }
+                });
+    return best;
+}
+
+void queryGridRect(const PointGrid2D& grid, const glm::vec2& lo, const glm::vec2& hi, std::vector<int>& out) {
+    out.clear();
+    if (grid.empty() || lo.x > hi.x || lo.y > hi.y) return;
+    forEachCell(grid,
+                cellCoord(lo.x, grid.cellSize), cellCoord(lo.y, grid.cellSize),
+                cellCoord(hi.x, grid.cellSize), cellCoord(hi.y, grid.cellSize),
+                [&](const std::vector<int>& bucket) {
+                    for (int i : bucket) {
+                        const glm::vec2& p = grid.positions[i];
+                        if (p.x >= lo.x && p.x <= hi.x && p.y >= lo.y && p.y <= hi.y) out.push_back(i);
+                    }
+                });
+    std::sort(out.begin(), out.end());
+}
+
+} // namespace Spline
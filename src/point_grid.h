@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Spline {
+
+// 2D 控制点的哈希网格：平面按 cellSize 划分为正方形格子，只为非空格子分配桶，坐标范围不受限制。
+// 网格自带一份点坐标副本，增删改都要经过下面的函数以保持一致；点下标与外部数组下标相同。
+// cellSize 取拾取半径左右时，半径查询最多访问 3×3 个格子。
+struct PointGrid2D {
+    float cellSize = 0.05f;
+    std::unordered_map<uint64_t, std::vector<int>> cells; // 格子键 → 点下标
+    std::vector<glm::vec2> positions;
+    std::vector<uint64_t> cellOf;                         // 点下标 → 所在格子键
+
+    size_t size() const { return positions.size(); }
+    bool empty() const { return positions.empty(); }
+};
+
+// 以 points 的 xy 分量重建；cellSize <= 0 时沿用原值
+void buildPointGrid(PointGrid2D& grid, const glm::vec3* points, size_t count, float cellSize = 0.0f);
+void clearPointGrid(PointGrid2D& grid);
+
+// 追加一个点，下标为追加前的 size()
+void appendGridPoint(PointGrid2D& grid, const glm::vec2& position);
+// 点 index 移动到 position；仍在原格子时只更新坐标
+void moveGridPoint(PointGrid2D& grid, int index, const glm::vec2& position);
+
+// 距离严格小于 radius 的点中最近的一个（距离相同时取下标小的），没有时返回 -1
+int findNearestGridPoint(const PointGrid2D& grid, const glm::vec2& position, float radius);
+
+// 落在闭矩形 [lo, hi] 内的点下标按升序写入 out（先清空）
+void queryGridRect(const PointGrid2D& grid, const glm::vec2& lo, const glm::vec2& hi, std::vector<int>& out);
+
+} // namespace Spline
@@ -0,0 +1,567 @@
+#include "point_projection.h"
+#include "spline.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace Spline {
+
+namespace {
+
+// 遍历栈深度上限：中位数划分的树高约为 log2(元素数 / kPatchLeafSize)
+constexpr int kMaxTraversalDepth = 64;
+// 初值采样：曲线段 kCurveSeeds 等分，面片 kSurfaceSeeds × kSurfaceSeeds 等分
+constexpr int kCurveSeeds = 8;
+constexpr int kSurfaceSeeds = 3;
+// Newton 步失效时退回二分 / 步长减半，迭代上限按二分收敛到 kParamEpsilon 所需的次数留足
+constexpr int kMaxRefineIterations = 32;
+// 面片上一步内步长减半的次数上限
+constexpr int kMaxStepHalvings = 12;
+// 最近点落在段 / 面片公共边界上时向相邻段 / 面片继续迭代的次数上限
+constexpr int kMaxNeighborHops = 4;
+// 参数步长小于此值时认为收敛
+constexpr float kParamEpsilon = 1e-6f;
+// 并行时每次领取的查询数
+constexpr size_t kQueryBlock = 256;
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+// 查询点到包围盒的距离平方
+float boundsDistance2(const glm::vec3& q, const glm::vec3& lo, const glm::vec3& hi) {
+    glm::vec3 d = glm::max(glm::max(lo - q, q - hi), glm::vec3(0.0f));
+    return glm::dot(d, d);
+}
+
+// Bernstein 基函数及其一、二阶导数：
+// B'_{i,n} = n (B_{i-1,n-1} - B_{i,n-1})，B''_{i,n} = n (n - 1) (B_{i-2,n-2} - 2 B_{i-1,n-2} + B_{i,n-2})。
+// 低阶基函数两端补零存放，越界项不必判断
+class BernsteinDerivatives {
+public:
+    explicit BernsteinDerivatives(int maxDegree)
+        : B(maxDegree + 1), dB(maxDegree + 1), d2B(maxDegree + 1), lower1(maxDegree + 2), lower2(maxDegree + 3) {}
+
+    void evaluate(int degree, float t) {
+        bernsteinBasis(degree, t, B.data());
+        // lower1[i + 1] = B_{i,n-1}，lower2[i + 2] = B_{i,n-2}
+        std::fill(lower1.begin(), lower1.end(), 0.0f);
+        std::fill(lower2.begin(), lower2.end(), 0.0f);
+        bernsteinBasis(degree - 1, t, lower1.data() + 1);
+        if (degree >= 2) bernsteinBasis(degree - 2, t, lower2.data() + 2);
+        float n1 = static_cast<float>(degree);
+        float n2 = degree >= 2 ? static_cast<float>(degree * (degree - 1)) : 0.0f;
+        for (int i = 0; i <= degree; ++i) {
+            dB[i] = n1 * (lower1[i] - lower1[i + 1]);
+            d2B[i] = n2 * (lower2[i] - 2.0f * lower2[i + 1] + lower2[i + 2]);
+        }
+    }
+
+    std::vector<float> B, dB, d2B;
+
+private:
+    std::vector<float> lower1, lower2;
+};
+
+float safeWeight(float w) {
+    return std::abs(w) > 1e-6f ? w : 1.0f;
+}
+
+// ========================
+// Curve
+// ========================
+class SegmentEvaluator {
+public:
+    explicit SegmentEvaluator(int degree) : degree(degree), basis(degree) {}
+
+    // 有理 Bezier 段的点与一、二阶导数（商的求导）
+    void evaluate(const glm::vec4* P, float t, glm::vec3& C, glm::vec3& C1, glm::vec3& C2) {
+        basis.evaluate(degree, t);
+        glm::vec4 H(0.0f), H1(0.0f), H2(0.0f);
+        for (int a = 0; a <= degree; ++a) {
+            H += basis.B[a] * P[a];
+            H1 += basis.dB[a] * P[a];
+            H2 += basis.d2B[a] * P[a];
+        }
+        float w = safeWeight(H.w);
+        C = glm::vec3(H) / w;
+        C1 = (glm::vec3(H1) - H1.w * C) / w;
+        C2 = (glm::vec3(H2) - 2.0f * H1.w * C1 - H2.w * C) / w;
+    }
+
+    // 只求点，用于初值采样
+    glm::vec3 evaluatePoint(const glm::vec4* P, float t) {
+        bernsteinBasis(degree, t, basis.B.data());
+        glm::vec4 H(0.0f);
+        for (int a = 0; a <= degree; ++a) H += basis.B[a] * P[a];
+        return glm::vec3(H) / safeWeight(H.w);
+    }
+
+private:
+    int degree;
+    BernsteinDerivatives basis;
+};
+
+// 在 [lo, hi] 内对 f(t) = (C - q)·C' 做有保护的 Newton 迭代，f'(t) = C'·C' + (C - q)·C''；迭代中更近的点写回 best*。
+// [lo, hi] 取初值两侧相邻的采样参数：初值是采样中的离散局部极小，区间内必有距离的局部极小。
+// 每步按 f 的符号收缩区间（f < 0 时极小在右侧），Newton 步落在区间外、f' 不为正或 |f| 下降不到一半时改为二分，
+// 不会像纯 Newton 那样在固定次数内来回振荡而停在未收敛的点上。区间收缩到端点时即为段端点处的约束极小
+void refineOnSegment(const glm::vec4* P, SegmentEvaluator& evaluator, const glm::vec3& q, float lo, float hi,
+                     float t, float& bestD2, float& local, glm::vec3& foot) {
+    glm::vec3 C, C1, C2;
+    float previousF = kInfinity;
+    for (int it = 0; it < kMaxRefineIterations; ++it) {
+        evaluator.evaluate(P, t, C, C1, C2);
+        glm::vec3 r = C - q;
+        float d2 = glm::dot(r, r);
+        if (d2 < bestD2) {
+            bestD2 = d2;
+            local = t;
+            foot = C;
+        }
+        float f = glm::dot(r, C1);
+        if (f < 0.0f) {
+            lo = t;
+        } else if (f > 0.0f) {
+            hi = t;
+        } else {
+            break;
+        }
+        if (hi - lo < kParamEpsilon) break;
+
+        float df = glm::dot(C1, C1) + glm::dot(r, C2);
+        float next = t - f / df;
+        if (!(df > 0.0f) || !(next > lo && next < hi) || std::abs(f) > 0.5f * previousF) next = 0.5f * (lo + hi);
+        previousF = std::abs(f);
+        if (std::abs(next - t) < kParamEpsilon) break;
+        t = next;
+    }
+}
+
+// 段 k 上的最近点：局部参数与距离平方。采样中的每个离散局部极小都作为初值迭代一次，避免收敛到较远的局部极小
+float projectToSegment(const BezierCurveSegments& segments, SegmentEvaluator& evaluator, int k,
+                       const glm::vec3& q, float& local, glm::vec3& foot) {
+    const glm::vec4* P = segments.segment(k);
+    float seedD2[kCurveSeeds + 1];
+    float bestD2 = kInfinity;
+    for (int s = 0; s <= kCurveSeeds; ++s) {
+        float t = static_cast<float>(s) / kCurveSeeds;
+        glm::vec3 C = evaluator.evaluatePoint(P, t);
+        seedD2[s] = glm::dot(C - q, C - q);
+        if (seedD2[s] < bestD2) {
+            bestD2 = seedD2[s];
+            local = t;
+            foot = C;
+        }
+    }
+    for (int s = 0; s <= kCurveSeeds; ++s) {
+        if (s > 0 && seedD2[s - 1] < seedD2[s]) continue;
+        if (s < kCurveSeeds && seedD2[s + 1] < seedD2[s]) continue;
+        float lo = static_cast<float>(std::max(s - 1, 0)) / kCurveSeeds;
+        float hi = static_cast<float>(std::min(s + 1, kCurveSeeds)) / kCurveSeeds;
+        refineOnSegment(P, evaluator, q, lo, hi, static_cast<float>(s) / kCurveSeeds, bestD2, local, foot);
+    }
+    return bestD2;
+}
+
+void projectToCurve(const BezierCurveSegments& segments, const PatchBVH& bvh, SegmentEvaluator& evaluator,
+                    const glm::vec3& q, CurveProjection& out) {
+    out = CurveProjection();
+    out.distance = kInfinity;
+    if (bvh.empty()) return;
+
+    float bestD2 = kInfinity;
+    float bestLocal = 0.0f;
+    struct Entry {
+        int node;
+        float dist2;
+    };
+    Entry stack[kMaxTraversalDepth];
+    int top = 0;
+    stack[top++] = {0, boundsDistance2(q, bvh.nodes[0].boundsMin, bvh.nodes[0].boundsMax)};
+    while (top > 0) {
+        Entry e = stack[--top];
+        if (e.dist2 >= bestD2) continue;
+        const PatchBVH::Node& node = bvh.nodes[e.node];
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                int k = bvh.order[i];
+                if (boundsDistance2(q, segments.boundsMin[k], segments.boundsMax[k]) >= bestD2) continue;
+                float local = 0.0f;
+                glm::vec3 foot(0.0f);
+                float d2 = projectToSegment(segments, evaluator, k, q, local, foot);
+                if (d2 < bestD2) {
+                    bestD2 = d2;
+                    bestLocal = local;
+                    out.point = foot;
+                    out.segment = k;
+                }
+            }
+            continue;
+        }
+        // 近的子节点后入栈、先出栈
+        const PatchBVH::Node& leftNode = bvh.nodes[node.first];
+        const PatchBVH::Node& rightNode = bvh.nodes[node.first + 1];
+        Entry l{node.first, boundsDistance2(q, leftNode.boundsMin, leftNode.boundsMax)};
+        Entry r{node.first + 1, boundsDistance2(q, rightNode.boundsMin, rightNode.boundsMax)};
+        if (l.dist2 > r.dist2) std::swap(l, r);
+        if (r.dist2 < bestD2 && top < kMaxTraversalDepth) stack[top++] = r;
+        if (l.dist2 < bestD2 && top < kMaxTraversalDepth) stack[top++] = l;
+    }
+    if (out.segment < 0) return;
+
+    // 最近点停在段端点、且沿参数方向还能向相邻段减小距离时，从相邻段的对应端点继续迭代：
+    // 相邻段的初值采样可能都不在这个极小的盆地里
+    int segmentCount = static_cast<int>(segments.segmentCount());
+    for (int hop = 0; hop < kMaxNeighborHops; ++hop) {
+        int k = out.segment;
+        glm::vec3 C, C1, C2;
+        evaluator.evaluate(segments.segment(k), bestLocal, C, C1, C2);
+        float f = glm::dot(C - q, C1);
+        int next = k;
+        float start = bestLocal;
+        if (bestLocal <= 0.0f && f > 0.0f && k > 0) {
+            next = k - 1;
+            start = 1.0f;
+        } else if (bestLocal >= 1.0f && f < 0.0f && k + 1 < segmentCount) {
+            next = k + 1;
+            start = 0.0f;
+        }
+        if (next == k) break;
+        float d2 = bestD2;
+        float local = start;
+        glm::vec3 foot(0.0f);
+        refineOnSegment(segments.segment(next), evaluator, q, 0.0f, 1.0f, start, d2, local, foot);
+        if (!(d2 < bestD2)) break;
+        bestD2 = d2;
+        bestLocal = local;
+        out.point = foot;
+        out.segment = next;
+    }
+    float u0 = segments.breakpoints[out.segment], u1 = segments.breakpoints[out.segment + 1];
+    out.u = u0 + bestLocal * (u1 - u0);
+    out.distance = std::sqrt(bestD2);
+}
+
+// ========================
+// Surface
+// ========================
+class PatchEvaluator {
+public:
+    PatchEvaluator(int degreeU, int degreeV)
+        : degreeU(degreeU), degreeV(degreeV), basisU(degreeU), basisV(degreeV) {}
+
+    struct Derivatives {
+        glm::vec3 S, Su, Sv, Suu, Suv, Svv;
+    };
+
+    // 有理 Bezier 面片的点与一、二阶偏导，局部参数 (s, t) ∈ [0,1]²
+    void evaluate(const glm::vec4* P, float s, float t, Derivatives& d) {
+        basisU.evaluate(degreeU, s);
+        basisV.evaluate(degreeV, t);
+        int orderV = degreeV + 1;
+        glm::vec4 H(0.0f), Hu(0.0f), Hv(0.0f), Huu(0.0f), Huv(0.0f), Hvv(0.0f);
+        for (int a = 0; a <= degreeU; ++a) {
+            glm::vec4 row(0.0f), rowV(0.0f), rowVV(0.0f);
+            for (int b = 0; b < orderV; ++b) {
+                const glm::vec4& p = P[a * orderV + b];
+                row += basisV.B[b] * p;
+                rowV += basisV.dB[b] * p;
+                rowVV += basisV.d2B[b] * p;
+            }
+            H += basisU.B[a] * row;
+            Hu += basisU.dB[a] * row;
+            Huu += basisU.d2B[a] * row;
+            Hv += basisU.B[a] * rowV;
+            Huv += basisU.dB[a] * rowV;
+            Hvv += basisU.B[a] * rowVV;
+        }
+        float w = safeWeight(H.w);
+        d.S = glm::vec3(H) / w;
+        d.Su = (glm::vec3(Hu) - Hu.w * d.S) / w;
+        d.Sv = (glm::vec3(Hv) - Hv.w * d.S) / w;
+        d.Suu = (glm::vec3(Huu) - 2.0f * Hu.w * d.Su - Huu.w * d.S) / w;
+        d.Svv = (glm::vec3(Hvv) - 2.0f * Hv.w * d.Sv - Hvv.w * d.S) / w;
+        d.Suv = (glm::vec3(Huv) - Hu.w * d.Sv - Hv.w * d.Su - Huv.w * d.S) / w;
+    }
+
+    // 只求点，用于初值采样
+    glm::vec3 evaluatePoint(const glm::vec4* P, float s, float t) {
+        bernsteinBasis(degreeU, s, basisU.B.data());
+        bernsteinBasis(degreeV, t, basisV.B.data());
+        int orderV = degreeV + 1;
+        glm::vec4 H(0.0f);
+        for (int a = 0; a <= degreeU; ++a) {
+            glm::vec4 row(0.0f);
+            for (int b = 0; b < orderV; ++b) row += basisV.B[b] * P[a * orderV + b];
+            H += basisU.B[a] * row;
+        }
+        return glm::vec3(H) / safeWeight(H.w);
+    }
+
+private:
+    int degreeU, degreeV;
+    BernsteinDerivatives basisU, basisV;
+};
+
+// 从 st 出发对 F = ((S - q)·Su, (S - q)·Sv) 做阻尼 Newton 迭代，J 为距离平方一半的 Hessian。
+// 完整的 Newton 步（投影回面片内）不减小距离时步长逐次减半，每步都是下降步：
+// 不会跳进别的盆地或停在鞍点附近，Newton 不收敛时也会沿下降方向继续走到局部极小
+void refineOnPatch(const glm::vec4* P, PatchEvaluator& evaluator, const glm::vec3& q, glm::vec2 st,
+                   float& bestD2, glm::vec2& local, glm::vec3& foot) {
+    PatchEvaluator::Derivatives d, trial;
+    evaluator.evaluate(P, st.x, st.y, d);
+    float d2 = glm::dot(d.S - q, d.S - q);
+    if (d2 < bestD2) {
+        bestD2 = d2;
+        local = st;
+        foot = d.S;
+    }
+    for (int it = 0; it < kMaxRefineIterations; ++it) {
+        glm::vec3 r = d.S - q;
+        float f = glm::dot(r, d.Su);
+        float g = glm::dot(r, d.Sv);
+        float a = glm::dot(d.Su, d.Su) + glm::dot(r, d.Suu);
+        float b = glm::dot(d.Su, d.Sv) + glm::dot(r, d.Suv);
+        float c = glm::dot(d.Sv, d.Sv) + glm::dot(r, d.Svv);
+        // 有效集：参数在边界上且梯度指向面片外时固定该参数，只沿另一方向做一维 Newton。
+        // 曲率不为正时退化为 Gauss-Newton；一维时只看该方向的二阶导，不受另一方向曲率为负的影响
+        bool fixU = (st.x <= 0.0f && f > 0.0f) || (st.x >= 1.0f && f < 0.0f);
+        bool fixV = (st.y <= 0.0f && g > 0.0f) || (st.y >= 1.0f && g < 0.0f);
+        glm::vec2 step(0.0f);
+        if (fixU && fixV) {
+            break;
+        } else if (fixU) {
+            if (!(c > 0.0f)) c = glm::dot(d.Sv, d.Sv);
+            if (!(c > 0.0f)) break;
+            step.y = g / c;
+        } else if (fixV) {
+            if (!(a > 0.0f)) a = glm::dot(d.Su, d.Su);
+            if (!(a > 0.0f)) break;
+            step.x = f / a;
+        } else {
+            if (a <= 0.0f || a * c - b * b <= 0.0f) {
+                a = glm::dot(d.Su, d.Su);
+                b = glm::dot(d.Su, d.Sv);
+                c = glm::dot(d.Sv, d.Sv);
+            }
+            float det = a * c - b * b;
+            if (!(det > 0.0f)) break;
+            step = glm::vec2(c * f - b * g, a * g - b * f) / det;
+        }
+        // Hessian 接近奇异时完整的 Newton 步可能远远越出面片，先把步长限制在半个面片以内
+        float longest = std::max(std::abs(step.x), std::abs(step.y));
+        if (longest > 0.5f) step *= 0.5f / longest;
+
+        glm::vec2 next = st;
+        float nextD2 = d2;
+        for (int h = 0; h < kMaxStepHalvings && nextD2 >= d2; ++h, step *= 0.5f) {
+            next = glm::clamp(st - step, 0.0f, 1.0f);
+            if (std::abs(next.x - st.x) + std::abs(next.y - st.y) < kParamEpsilon) break;
+            evaluator.evaluate(P, next.x, next.y, trial);
+            nextD2 = glm::dot(trial.S - q, trial.S - q);
+        }
+        if (!(nextD2 < d2)) break;
+        bool converged = std::abs(next.x - st.x) + std::abs(next.y - st.y) < kParamEpsilon;
+        st = next;
+        d = trial;
+        d2 = nextD2;
+        if (d2 < bestD2) {
+            bestD2 = d2;
+            local = st;
+            foot = d.S;
+        }
+        if (converged) break;
+    }
+}
+
+// 面片 k 上的最近点，初值取法同 projectToSegment（四邻域的离散局部极小）
+float projectToPatch(const BezierSurfacePatches& patches, PatchEvaluator& evaluator, int k,
+                     const glm::vec3& q, glm::vec2& local, glm::vec3& foot) {
+    constexpr int n = kSurfaceSeeds + 1;
+    const glm::vec4* P = patches.patch(k);
+    float seedD2[n][n];
+    float bestD2 = kInfinity;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            glm::vec2 st(static_cast<float>(i) / kSurfaceSeeds, static_cast<float>(j) / kSurfaceSeeds);
+            glm::vec3 S = evaluator.evaluatePoint(P, st.x, st.y);
+            seedD2[i][j] = glm::dot(S - q, S - q);
+            if (seedD2[i][j] < bestD2) {
+                bestD2 = seedD2[i][j];
+                local = st;
+                foot = S;
+            }
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            float d2 = seedD2[i][j];
+            if ((i > 0 && seedD2[i - 1][j] < d2) || (i + 1 < n && seedD2[i + 1][j] < d2) ||
+                (j > 0 && seedD2[i][j - 1] < d2) || (j + 1 < n && seedD2[i][j + 1] < d2))
+                continue;
+            glm::vec2 st(static_cast<float>(i) / kSurfaceSeeds, static_cast<float>(j) / kSurfaceSeeds);
+            refineOnPatch(P, evaluator, q, st, bestD2, local, foot);
+        }
+    }
+    return bestD2;
+}
+
+void projectToSurface(const BezierSurfacePatches& patches, const PatchBVH& bvh, PatchEvaluator& evaluator,
+                      const glm::vec3& q, SurfaceProjection& out) {
+    out = SurfaceProjection();
+    out.distance = kInfinity;
+    if (bvh.empty()) return;
+
+    float bestD2 = kInfinity;
+    glm::vec2 bestLocal(0.0f);
+    struct Entry {
+        int node;
+        float dist2;
+    };
+    Entry stack[kMaxTraversalDepth];
+    int top = 0;
+    stack[top++] = {0, boundsDistance2(q, bvh.nodes[0].boundsMin, bvh.nodes[0].boundsMax)};
+    while (top > 0) {
+        Entry e = stack[--top];
+        if (e.dist2 >= bestD2) continue;
+        const PatchBVH::Node& node = bvh.nodes[e.node];
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                int k = bvh.order[i];
+                if (boundsDistance2(q, patches.boundsMin[k], patches.boundsMax[k]) >= bestD2) continue;
+                glm::vec2 local(0.0f);
+                glm::vec3 foot(0.0f);
+                float d2 = projectToPatch(patches, evaluator, k, q, local, foot);
+                if (d2 < bestD2) {
+                    bestD2 = d2;
+                    bestLocal = local;
+                    out.point = foot;
+                    out.patch = k;
+                }
+            }
+            continue;
+        }
+        const PatchBVH::Node& leftNode = bvh.nodes[node.first];
+        const PatchBVH::Node& rightNode = bvh.nodes[node.first + 1];
+        Entry l{node.first, boundsDistance2(q, leftNode.boundsMin, leftNode.boundsMax)};
+        Entry r{node.first + 1, boundsDistance2(q, rightNode.boundsMin, rightNode.boundsMax)};
+        if (l.dist2 > r.dist2) std::swap(l, r);
+        if (r.dist2 < bestD2 && top < kMaxTraversalDepth) stack[top++] = r;
+        if (l.dist2 < bestD2 && top < kMaxTraversalDepth) stack[top++] = l;
+    }
+    if (out.patch < 0) return;
+
+    // 同曲线：最近点停在面片公共边上、且梯度指向相邻面片时，从相邻面片的对应点继续迭代
+    const int countU = patches.patchCountU(), countV = patches.patchCountV();
+    PatchEvaluator::Derivatives d;
+    for (int hop = 0; hop < kMaxNeighborHops; ++hop) {
+        int pu = out.patch / countV, pv = out.patch % countV;
+        evaluator.evaluate(patches.patch(out.patch), bestLocal.x, bestLocal.y, d);
+        float f = glm::dot(d.S - q, d.Su);
+        float g = glm::dot(d.S - q, d.Sv);
+        int nu = pu, nv = pv;
+        glm::vec2 start = bestLocal;
+        if (bestLocal.x <= 0.0f && f > 0.0f && pu > 0) {
+            nu = pu - 1;
+            start.x = 1.0f;
+        } else if (bestLocal.x >= 1.0f && f < 0.0f && pu + 1 < countU) {
+            nu = pu + 1;
+            start.x = 0.0f;
+        }
+        if (bestLocal.y <= 0.0f && g > 0.0f && pv > 0) {
+            nv = pv - 1;
+            start.y = 1.0f;
+        } else if (bestLocal.y >= 1.0f && g < 0.0f && pv + 1 < countV) {
+            nv = pv + 1;
+            start.y = 0.0f;
+        }
+        if (nu == pu && nv == pv) break;
+        int next = nu * countV + nv;
+        float d2 = bestD2;
+        glm::vec2 local = start;
+        glm::vec3 foot(0.0f);
+        refineOnPatch(patches.patch(next), evaluator, q, start, d2, local, foot);
+        if (!(d2 < bestD2)) break;
+        bestD2 = d2;
+        bestLocal = local;
+        out.point = foot;
+        out.patch = next;
+    }
+    int pu = out.patch / countV, pv = out.patch % countV;
+    float u0 = patches.breakpointsU[pu], u1 = patches.breakpointsU[pu + 1];
+    float v0 = patches.breakpointsV[pv], v1 = patches.breakpointsV[pv + 1];
+    out.uv = glm::vec2(u0 + bestLocal.x * (u1 - u0), v0 + bestLocal.y * (v1 - v0));
+    out.distance = std::sqrt(bestD2);
+}
+
+// ========================
+// Parallel Driver
+// ========================
+// 查询按 kQueryBlock 动态分块；work(begin, end) 在各线程上调用，线程内状态（求值缓冲）由 work 自行创建
+template <typename Work>
+void parallelQueries(size_t count, unsigned threads, Work&& work) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t useful = (count + kMinQueriesPerThread - 1) / kMinQueriesPerThread;
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(useful, 1)));
+    if (threads <= 1) {
+        work(0, count);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (;;) {
+            size_t begin = next.fetch_add(kQueryBlock, std::memory_order_relaxed);
+            if (begin >= count) break;
+            work(begin, std::min(begin + kQueryBlock, count));
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+}
+
+} // namespace
+
+// ========================
+// 1. Batch Projection
+// ========================
+void projectPointsToCurve(const BezierCurveSegments& segments, const PatchBVH& bvh,
+                          const glm::vec3* queries, size_t count, CurveProjection* results,
+                          unsigned threads) {
+    bool usable = segments.segmentCount() > 0 && bvh.order.size() == segments.segmentCount();
+    parallelQueries(count, threads, [&](size_t begin, size_t end) {
+        SegmentEvaluator evaluator(segments.degree);
+        for (size_t i = begin; i < end; ++i) {
+            if (usable) {
+                projectToCurve(segments, bvh, evaluator, queries[i], results[i]);
+            } else {
+                results[i] = CurveProjection();
+                results[i].distance = kInfinity;
+            }
+        }
+    });
+}
+
+void projectPointsToSurface(const BezierSurfacePatches& patches, const PatchBVH& bvh,
+                            const glm::vec3* queries, size_t count, SurfaceProjection* results,
+                            unsigned threads) {
+    bool usable = patches.patchCount() > 0 && bvh.order.size() == patches.patchCount();
+    parallelQueries(count, threads, [&](size_t begin, size_t end) {
+        PatchEvaluator evaluator(patches.degreeU, patches.degreeV);
+        for (size_t i = begin; i < end; ++i) {
+            if (usable) {
+                projectToSurface(patches, bvh, evaluator, queries[i], results[i]);
+            } else {
+                results[i] = SurfaceProjection();
+                results[i].distance = kInfinity;
+            }
+        }
+    });
+}
+
+} // namespace Spline
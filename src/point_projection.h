@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "bezier_extraction.h"
+#include "surface_raycast.h"
+
+namespace Spline {
+
+// 点求逆：查询点在曲线 / 曲面上的最近点。没有可投影的段或面片时 segment / patch 为 -1，distance 为 +inf
+struct CurveProjection {
+    float u = 0.0f;                     // 全局参数，与 evaluate* 的 u 相同
+    glm::vec3 point = glm::vec3(0.0f);  // 最近点
+    float distance = 0.0f;
+    int segment = -1;
+};
+
+struct SurfaceProjection {
+    glm::vec2 uv = glm::vec2(0.0f);     // 全局参数，与 evaluate*Surface 的 (u, v) 相同
+    glm::vec3 point = glm::vec3(0.0f);
+    float distance = 0.0f;
+    int patch = -1;
+};
+
+// 少于此数的查询只在调用线程上计算
+constexpr size_t kMinQueriesPerThread = 1024;
+
+// 批量投影。bvh 由 buildPatchBVH(bvh, segments / patches) 构建。
+// 每个查询按包围盒距离由近到远遍历 BVH，包围盒距离不小于当前最近距离的段 / 面片直接跳过；
+// 候选段 / 面片以粗采样中的离散局部极小为初值，对 (C - q)·C' = 0（曲面为两个偏导方向）做 Newton 迭代，
+// 参数限制在段 / 面片内（落在边界上时只沿边界迭代）；Newton 步失效时曲线退回区间二分、曲面退回步长减半，
+// 保证收敛到局部极小。最近点停在与相邻段 / 面片的公共边界上时从相邻一侧继续迭代。
+// 查询之间相互独立，threads 个线程动态分块并行（0 表示硬件线程数）
+void projectPointsToCurve(const BezierCurveSegments& segments, const PatchBVH& bvh,
+                          const glm::vec3* queries, size_t count, CurveProjection* results,
+                          unsigned threads = 0);
+void projectPointsToSurface(const BezierSurfacePatches& patches, const PatchBVH& bvh,
+                            const glm::vec3* queries, size_t count, SurfaceProjection* results,
+                            unsigned threads = 0);
+
+} // namespace Spline
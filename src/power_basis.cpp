@@ -0,0 +1,108 @@
+#include "power_basis.h"
+#include "spline.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Spline {
+
+bool shouldUsePowerBasis(int numControlPoints, int degree, int numSamples) {
+    return degree >= 1 && degree <= kPowerBasisMaxDegree &&
+           numSamples >= kPowerBasisMinSamplesPerPoint * numControlPoints;
+}
+
+// ========================
+// 1. Bezier -> 幂基转换
+// ========================
+// a_j = C(p, j) * sum_{i=0..j} (-1)^(j-i) * C(j, i) * P_i
+PowerBasisCurve buildPowerBasisCurve(const BezierCurveSegments& segments, bool rational) {
+    PowerBasisCurve curve;
+    curve.degree = segments.degree;
+    curve.rational = rational;
+    curve.breakpoints = segments.breakpoints;
+
+    int p = segments.degree;
+    size_t count = segments.segmentCount();
+    curve.coefficients.resize(count * (p + 1));
+    for (size_t k = 0; k < count; ++k) {
+        const glm::vec4* P = segments.segment(k);
+        glm::vec4* a = &curve.coefficients[k * (p + 1)];
+        for (int j = 0; j <= p; ++j) {
+            glm::dvec4 sum(0.0);
+            for (int i = 0; i <= j; ++i) {
+                double c = binomialCoefficient(j, i) * (((j - i) & 1) ? -1.0 : 1.0);
+                sum += c * glm::dvec4(P[i]);
+            }
+            a[j] = glm::vec4(static_cast<double>(binomialCoefficient(p, j)) * sum);
+        }
+    }
+    return curve;
+}
+
+// ========================
+// 2. Horner 求值
+// ========================
+size_t evaluatePowerBasisCurve(const PowerBasisCurve& curve, int numSamples, glm::vec3* result, size_t capacity) {
+    size_t count = curve.spanCount();
+    if (count == 0 || numSamples < 1 || capacity < static_cast<size_t>(numSamples) + 1) return 0;
+
+    int p = curve.degree;
+    // 采样参数单调递增，节点区间只需顺序推进
+    size_t k = 0;
+    float left = curve.breakpoints[0];
+    float invWidth = 1.0f / (curve.breakpoints[1] - curve.breakpoints[0]);
+    for (int s = 0; s <= numSamples; ++s) {
+        float u = static_cast<float>(s) / numSamples;
+        if (k + 1 < count && u >= curve.breakpoints[k + 1]) {
+            while (k + 1 < count && u >= curve.breakpoints[k + 1]) ++k;
+            left = curve.breakpoints[k];
+            invWidth = 1.0f / (curve.breakpoints[k + 1] - left);
+        }
+        float t = (u - left) * invWidth;
+
+        const glm::vec4* a = &curve.coefficients[k * (p + 1)];
+        glm::vec4 h = a[p];
+        for (int j = p - 1; j >= 0; --j) h = h * t + a[j];
+
+        if (curve.rational && std::abs(h.w) > 1e-6f) {
+            result[s] = glm::vec3(h) / h.w;
+        } else {
+            result[s] = glm::vec3(h);
+        }
+    }
+    return static_cast<size_t>(numSamples) + 1;
+}
+
+std::vector<glm::vec3> evaluatePowerBasisCurve(const PowerBasisCurve& curve, int numSamples) {
+    std::vector<glm::vec3> result(curve.spanCount() == 0 || numSamples < 1 ? 0 : numSamples + 1);
+    evaluatePowerBasisCurve(curve, numSamples, result.data(), result.size());
+    return result;
+}
+
+// ========================
+// 3. 缓存
+// ========================
+const PowerBasisCurve& getPowerBasisCurve(PowerBasisCache& cache,
+                                          const std::vector<glm::vec3>& controlPoints,
+                                          const std::vector<float>& weights,
+                                          int degree,
+                                          uint64_t pointsGeneration,
+                                          uint64_t weightsGeneration) {
+    bool rational = !weights.empty();
+    // 多项式曲线不使用权重，权重修改不触发重建
+    if (!rational) weightsGeneration = 0;
+    int numControlPoints = static_cast<int>(controlPoints.size());
+    if (!cache.valid || cache.rational != rational || cache.numControlPoints != numControlPoints ||
+        cache.degree != degree ||
+        cache.pointsGeneration != pointsGeneration || cache.weightsGeneration != weightsGeneration) {
+        cache.curve = buildPowerBasisCurve(extractBezierSegments(controlPoints, weights, degree), rational);
+        cache.rational = rational;
+        cache.numControlPoints = numControlPoints;
+        cache.degree = degree;
+        cache.pointsGeneration = pointsGeneration;
+        cache.weightsGeneration = weightsGeneration;
+        cache.valid = true;
+    }
+    return cache.curve;
+}
+
+} // namespace Spline
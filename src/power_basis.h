@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "bezier_extraction.h"
+
+namespace Spline {
+
+// 逐节点区间的幂基多项式形式：第 k 段在局部参数 t ∈ [0, 1] 上为
+// C_k(t) = sum_j coefficients[k * (degree + 1) + j] * t^j（齐次坐标），
+// 每个采样只需一次 degree 次 Horner 求值。只适合低次（高次幂基在 float 下数值不稳定）。
+struct PowerBasisCurve {
+    int degree = 0;
+    bool rational = false;
+    std::vector<float> breakpoints;       // spanCount() + 1 个参数分界
+    std::vector<glm::vec4> coefficients;  // 按段连续存放，段内由低次到高次
+
+    size_t spanCount() const { return breakpoints.empty() ? 0 : breakpoints.size() - 1; }
+};
+
+// 超过该次数不使用幂基形式（6 次起 float 系数的相消误差明显增大）
+constexpr int kPowerBasisMaxDegree = 5;
+// 采样数至少为控制点数的该倍数时，转换开销可被摊薄
+constexpr int kPowerBasisMinSamplesPerPoint = 8;
+
+bool shouldUsePowerBasis(int numControlPoints, int degree, int numSamples);
+
+// 由 Bezier 分段形式转换（双精度计算后存为 float）
+PowerBasisCurve buildPowerBasisCurve(const BezierCurveSegments& segments, bool rational);
+
+// 在 u = s / numSamples (s = 0..numSamples) 上求值，输出布局与 evaluateBSpline / evaluateNURBS 一致
+std::vector<glm::vec3> evaluatePowerBasisCurve(const PowerBasisCurve& curve, int numSamples);
+// 写入 out[0..capacity)：需要 numSamples + 1 个元素，返回写入个数，容量不足时返回 0
+size_t evaluatePowerBasisCurve(const PowerBasisCurve& curve, int numSamples, glm::vec3* out, size_t capacity);
+
+// 按编辑缓存的幂基形式：控制点 / 权重的修改计数、控制点数、次数或有理性变化时重新提取并转换；
+// 绕过修改计数直接改写控制点时调用 invalidate()
+struct PowerBasisCache {
+    PowerBasisCurve curve;
+    bool valid = false;
+    bool rational = false;
+    int numControlPoints = 0;
+    int degree = 0;
+    uint64_t pointsGeneration = 0, weightsGeneration = 0;
+
+    void invalidate() { valid = false; }
+};
+
+// pointsGeneration / weightsGeneration 为调用方 Generation 的 value。
+// weights 为空时为多项式 B 样条，weightsGeneration 被忽略
+const PowerBasisCurve& getPowerBasisCurve(PowerBasisCache& cache,
+                                          const std::vector<glm::vec3>& controlPoints,
+                                          const std::vector<float>& weights,
+                                          int degree,
+                                          uint64_t pointsGeneration,
+                                          uint64_t weightsGeneration);
+
+} // namespace Spline
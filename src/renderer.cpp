@@ -1,8 +1,22 @@
 #include "renderer.h"
 #include "shader_s.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <iostream>
 
+namespace {
+
+// shader.vs 中 Camera uniform 块的绑定点
+constexpr unsigned int kCameraBinding = 0;
+
+// ID 缓冲中的物体 ID：0 为背景，控制点为 kControlPointIdBase + 下标
+constexpr unsigned int kSurfaceId = 1;
+constexpr unsigned int kControlPointIdBase = 2;
+// 拾取时控制点画得比显示时大，与 CPU 拾取的悬停半径相当
+constexpr float kPickPointSize = 12.0f;
+
+} // namespace
+
 Renderer::Renderer() {
     // --- 初始化 VAO/VBO（3D 顶点）---
     auto setupVAO = [](unsigned int& vao, unsigned int& vbo) {
@@ -22,12 +36,33 @@ Renderer::Renderer() {
 
     // 加载着色器
     try {
-        pointShader = new Shader("../src/shaders/shader.vs", "../src/shaders/shader.fs");
-        lineShader  = new Shader("../src/shaders/shader.vs", "../src/shaders/shader.fs");
-        curveShader = new Shader("../src/shaders/shader.vs", "../src/shaders/shader.fs");
+        flatShader = new Shader("../src/shaders/shader.vs", "../src/shaders/shader.fs");
+        colorLocation = glGetUniformLocation(flatShader->ID, "uColor");
+        pointSizeLocation = glGetUniformLocation(flatShader->ID, "pointSize");
+        unsigned int cameraBlock = glGetUniformBlockIndex(flatShader->ID, "Camera");
+        if (cameraBlock != GL_INVALID_INDEX) glUniformBlockBinding(flatShader->ID, cameraBlock, kCameraBinding);
     } catch (...) {
         std::cerr << "Failed to load shaders!" << std::endl;
     }
+    try {
+        pickShader = new Shader("../src/shaders/pick.vs", "../src/shaders/pick.fs");
+        pickPointSizeLocation = glGetUniformLocation(pickShader->ID, "pointSize");
+        pickBaseVertexLocation = glGetUniformLocation(pickShader->ID, "uBaseVertex");
+        pickGridLocation = glGetUniformLocation(pickShader->ID, "uGrid");
+        pickIdBaseLocation = glGetUniformLocation(pickShader->ID, "uIdBase");
+        pickVertexIdsLocation = glGetUniformLocation(pickShader->ID, "uVertexIds");
+        unsigned int cameraBlock = glGetUniformBlockIndex(pickShader->ID, "Camera");
+        if (cameraBlock != GL_INVALID_INDEX) glUniformBlockBinding(pickShader->ID, cameraBlock, kCameraBinding);
+    } catch (...) {
+        std::cerr << "Failed to load picking shaders!" << std::endl;
+    }
+
+    // 相机 uniform 缓冲区：两个 mat4，std140 下紧密排列
+    glGenBuffers(1, &cameraUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kCameraBinding, cameraUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
     // 默认 2D 正交视图（NDC 空间 [-1,1]）
     viewMat = glm::mat4(1.0f);
@@ -86,6 +121,7 @@ Renderer::Renderer() {
     glGenVertexArrays(1, &surfaceVAO);
     glGenBuffers(1, &surfaceVBO);
     glGenBuffers(1, &surfaceEBO); // ← 新增
+    glGenBuffers(1, &surfaceLineEBO);
 
     glBindVertexArray(surfaceVAO);
 
@@ -102,21 +138,23 @@ Renderer::Renderer() {
     glBindVertexArray(0);
 
 
-    // --- 创建线框 VAO/VBO ---
-    glGenVertexArrays(1, &wireframeVAO);
-    glGenBuffers(1, &wireframeVBO);
-    glBindVertexArray(wireframeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, wireframeVBO);
+    // --- 曲面控制网格 VAO/VBO/EBO（齐次 vec4；EBO 为线框索引）---
+    glGenVertexArrays(1, &netVAO);
+    glGenBuffers(1, &netVBO);
+    glGenBuffers(1, &netEBO);
+    glBindVertexArray(netVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, netVBO);
     glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
     glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, netEBO);
     glBindVertexArray(0);
 }
 
 Renderer::~Renderer() {
-    if (pointShader) delete pointShader;
-    if (lineShader)  delete lineShader;
-    if (curveShader) delete curveShader;
+    if (flatShader) delete flatShader;
+    if (pickShader) delete pickShader;
+    glDeleteBuffers(1, &cameraUBO);
 
     glDeleteVertexArrays(1, &pointVAO);
     glDeleteVertexArrays(1, &polyVAO);
@@ -132,105 +170,262 @@ Renderer::~Renderer() {
     glDeleteBuffers(1, &surfaceVAO);
     glDeleteBuffers(1, &surfaceVBO);
     glDeleteBuffers(1, &surfaceEBO);
-    glDeleteBuffers(1, &wireframeVAO);
-    glDeleteBuffers(1, &wireframeVBO);
+    glDeleteBuffers(1, &surfaceLineEBO);
+    glDeleteVertexArrays(1, &netVAO);
+    glDeleteBuffers(1, &netVBO);
+    glDeleteBuffers(1, &netEBO);
 }
 
 void Renderer::setOrtho(float left, float right, float bottom, float top) {
-    projMat = glm::ortho(left, right, bottom, top, -1.0f, 1.0f);
+    setProjectionMatrix(glm::ortho(left, right, bottom, top, -1.0f, 1.0f));
 }
 
 void Renderer::setViewMatrix(const glm::mat4& view) {
+    if (view == viewMat) return;
     viewMat = view;
+    cameraDirty = true;
 }
 
 void Renderer::setProjectionMatrix(const glm::mat4& proj) {
+    if (proj == projMat) return;
     projMat = proj;
+    cameraDirty = true;
+}
+
+void Renderer::uploadCamera() {
+    if (!cameraDirty) return;
+    glm::mat4 matrices[2] = {viewMat, projMat};
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(matrices), &matrices[0][0][0]);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    cameraDirty = false;
+}
+
+bool Renderer::useFlatShader() {
+    if (!flatShader) return false;
+    uploadCamera();
+    flatShader->use();
+    return true;
+}
+
+void Renderer::setColor(float r, float g, float b, float a) {
+    glUniform4f(colorLocation, r, g, b, a);
 }
 
 
 // --- Update functions (vec3) ---
-void Renderer::updateControlPoints(const std::vector<glm::vec3>& points) {
-    if (points == controlPoints) return;
-    controlPoints = points;
-    glBindBuffer(GL_ARRAY_BUFFER, pointVBO);
-    glBufferData(GL_ARRAY_BUFFER, points.size() * sizeof(glm::vec3), points.data(), GL_DYNAMIC_DRAW);
+void Renderer::updateControlPoints(const std::vector<glm::vec3>& points, uint64_t generation) {
+    if (!controlPoints.update(generation, points.size())) return;
+    uploadGrowing(GL_ARRAY_BUFFER, pointVBO, controlPoints.capacity, points.data(), points.size() * sizeof(glm::vec3));
 }
 
-void Renderer::updateControlPolygon(const std::vector<glm::vec3>& points) {
-    if (points == controlPolygon) return;
-    controlPolygon = points;
-    glBindBuffer(GL_ARRAY_BUFFER, polyVBO);
-    glBufferData(GL_ARRAY_BUFFER, points.size() * sizeof(glm::vec3), points.data(), GL_DYNAMIC_DRAW);
+void Renderer::updateControlNet(const Spline::ControlNet& net) {
+    if (!controlNetPoints.update(net.generation(), net.points.size())) return;
+    uploadGrowing(GL_ARRAY_BUFFER, netVBO, controlNetPoints.capacity,
+                  net.points.data(), net.points.size() * sizeof(glm::vec4));
 }
 
-void Renderer::updateCurve(const std::vector<glm::vec3>& points) {
-    if (points == curve) return;
-    curve = points;
-    glBindBuffer(GL_ARRAY_BUFFER, curveVBO);
-    glBufferData(GL_ARRAY_BUFFER, points.size() * sizeof(glm::vec3), points.data(), GL_DYNAMIC_DRAW);
+void Renderer::updateControlPolygon(const std::vector<glm::vec3>& points, uint64_t generation) {
+    if (!controlPolygon.update(generation, points.size())) return;
+    uploadGrowing(GL_ARRAY_BUFFER, polyVBO, controlPolygon.capacity, points.data(), points.size() * sizeof(glm::vec3));
 }
 
-void Renderer::updateSurface(
-    const std::vector<glm::vec3>& positions,
-    const std::vector<unsigned int>& indices
-) {
-    if (positions == surfacePositions && indices == surfaceIndices) return;
+void Renderer::updateCurve(const std::vector<glm::vec3>& points, uint64_t generation) {
+    if (!curve.update(generation, points.size())) return;
+    if (glm::vec3* dst = beginCurveWrite(points.size())) {
+        std::copy(points.begin(), points.end(), dst);
+        commitCurve(points.size(), generation);
+        return;
+    }
+    curve.first = 0;
+    uploadGrowing(GL_ARRAY_BUFFER, curveVBO, curve.capacity, points.data(), points.size() * sizeof(glm::vec3));
+}
+
+void Renderer::updateSurface(const std::vector<glm::vec3>& positions, uint64_t generation) {
+    if (!surfacePositions.update(generation, positions.size())) return;
+
+    if (glm::vec3* dst = streaming ? beginStream(surfaceStream, surfaceVAO, positions.size()) : nullptr) {
+        // 局部更新期间 VAO 指向 surfaceVBO，全量重建时切回环形缓冲区
+        if (!surfaceStreamBound) {
+            bindVertexSource(surfaceVAO, surfaceStream.id());
+            surfaceStreamBound = true;
+        }
+        std::copy(positions.begin(), positions.end(), dst);
+        surfacePositions.first = surfaceStream.drawOffset() / sizeof(glm::vec3);
+    } else {
+        surfacePositions.first = 0;
+        uploadGrowing(GL_ARRAY_BUFFER, surfaceVBO, surfacePositions.capacity,
+                      positions.data(), positions.size() * sizeof(glm::vec3));
+    }
+}
+
+void Renderer::setSurfaceTopology(const Spline::SurfaceTopology& topology) {
+    uploadTopology(surfaceIndices, surfaceVAO, surfaceEBO, topology);
+}
+
+void Renderer::setSurfaceLineTopology(const Spline::SurfaceTopology& topology) {
+    uploadTopology(surfaceLineIndices, surfaceVAO, surfaceLineEBO, topology);
+}
 
-    surfacePositions = positions;
-    surfaceIndices = indices;
+void Renderer::setSurfaceRenderMode(SurfaceRenderMode mode) {
+    surfaceMode = mode;
+}
+
+void Renderer::setControlNetTopology(const Spline::SurfaceTopology& topology) {
+    uploadTopology(netIndices, netVAO, netEBO, topology);
+}
+
+void Renderer::uploadTopology(UploadedTopology& state, unsigned int vao, unsigned int ebo,
+                              const Spline::SurfaceTopology& topology) {
+    if (topology.uSamples == state.uSamples && topology.vSamples == state.vSamples &&
+        topology.layout == state.layout && topology.lineStride == state.lineStride) return;
+    state.uSamples = topology.uSamples;
+    state.vSamples = topology.vSamples;
+    state.layout = topology.layout;
+    state.lineStride = topology.lineStride;
+    state.compact = topology.compact;
+    state.count = topology.indexCount();
+    // EBO 绑定属于 VAO 状态，上传时绑定所属 VAO，避免改动其他 VAO
+    glBindVertexArray(vao);
+    uploadGrowing(GL_ELEMENT_ARRAY_BUFFER, ebo, state.capacity,
+                  topology.data(), topology.indexCount() * topology.indexSize());
+    glBindVertexArray(0);
+}
+
+void Renderer::drawTopology(const UploadedTopology& state, size_t baseVertex) {
+    bool strips = state.layout == Spline::IndexLayout::TriangleStrips;
+    GLenum mode = strips ? GL_TRIANGLE_STRIP
+                : state.layout == Spline::IndexLayout::GridLines ? GL_LINES : GL_TRIANGLES;
+    if (strips) {
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(state.compact ? 0xFFFFu : 0xFFFFFFFFu);
+    }
+    // 重启索引按基顶点偏移之前的原始值比较
+    glDrawElementsBaseVertex(mode,
+                             static_cast<GLsizei>(state.count),
+                             state.compact ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                             (void*)0,
+                             static_cast<GLint>(baseVertex));
+    if (strips) glDisable(GL_PRIMITIVE_RESTART);
+}
+
+void Renderer::updateSurfaceRange(
+    const std::vector<glm::vec3>& positions, int rowStride,
+    int rowBegin, int rowEnd, int colBegin, int colEnd,
+    uint64_t generation
+) {
+    // 顶点数变化说明拓扑已变，脏矩形超出网格说明调用方的行列与 positions 不匹配：
+    // 都回退为全量上传，不留下过期的缓冲区
+    bool rectInGrid = rowStride > 0 && rowBegin >= 0 && colBegin >= 0 && colEnd <= rowStride &&
+                      static_cast<size_t>(rowEnd) * rowStride <= positions.size();
+    if (positions.size() != surfacePositions.count || !rectInGrid) {
+        updateSurface(positions, generation);
+        return;
+    }
+    if (rowBegin >= rowEnd || colBegin >= colEnd) return;
+    if (!surfacePositions.update(generation, positions.size())) return;
+
+    // 拖拽等局部编辑不走流式上传：新段里没有上一版数据，每次都要整份写入。
+    // 上一版在环形缓冲区中（全量重建后的第一次编辑）时整份上传到 VBO 一次并把 VAO 切回 VBO
+    if (surfaceStreamBound) {
+        bindVertexSource(surfaceVAO, surfaceVBO);
+        surfaceStreamBound = false;
+        surfacePositions.first = 0;
+        uploadGrowing(GL_ARRAY_BUFFER, surfaceVBO, surfacePositions.capacity,
+                      positions.data(), positions.size() * sizeof(glm::vec3));
+        return;
+    }
 
-    // 更新 VBO
     glBindBuffer(GL_ARRAY_BUFFER, surfaceVBO);
-    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_DYNAMIC_DRAW);
+    // 整行脏时各行首尾相接，合并为一次上传
+    bool fullRows = colBegin == 0 && colEnd == rowStride;
+    int runs = fullRows ? 1 : rowEnd - rowBegin;
+    size_t runLength = fullRows ? static_cast<size_t>(rowEnd - rowBegin) * rowStride
+                                : static_cast<size_t>(colEnd - colBegin);
+    for (int r = 0; r < runs; ++r) {
+        size_t first = static_cast<size_t>(rowBegin + r) * rowStride + colBegin;
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(glm::vec3),
+                        runLength * sizeof(glm::vec3), positions.data() + first);
+    }
+}
+
+// --- Streaming ---
+bool Renderer::enableStreaming(GLProcLoader loader) {
+    streaming = loadBufferStorage(loader);
+    return streaming;
+}
+
+glm::vec3* Renderer::beginCurveWrite(size_t count) {
+    return streaming ? beginStream(curveStream, curveVAO, count) : nullptr;
+}
+
+void Renderer::commitCurve(size_t count, uint64_t generation) {
+    curve.generation = generation;
+    curve.count = count;
+    curve.first = curveStream.drawOffset() / sizeof(glm::vec3);
+}
+
+void Renderer::endFrame() {
+    if (!streaming) return;
+    curveStream.fence();
+    surfaceStream.fence();
+}
 
-    // 更新 EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surfaceEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_DYNAMIC_DRAW);
+glm::vec3* Renderer::beginStream(StreamRingBuffer& ring, unsigned int vao, size_t count) {
+    size_t bytes = std::max<size_t>(count, 1) * sizeof(glm::vec3);
+    if (bytes > ring.segmentSize()) {
+        // 段容量按 2 倍增长，保持为顶点大小的整数倍
+        if (!ring.create(std::max(bytes, ring.segmentSize() * 2))) {
+            streaming = false;
+            curveStream.destroy();
+            surfaceStream.destroy();
+            bindVertexSource(curveVAO, curveVBO);
+            bindVertexSource(surfaceVAO, surfaceVBO);
+            surfaceStreamBound = false;
+            // 另一路的数据随环形缓冲区一起丢弃，下次更新时重新上传
+            UploadedBuffer& other = vao == curveVAO ? surfacePositions : curve;
+            other = UploadedBuffer{0, 0, other.capacity, 0};
+            return nullptr;
+        }
+        bindVertexSource(vao, ring.id());
+        if (vao == surfaceVAO) surfaceStreamBound = true;
+    }
+    return static_cast<glm::vec3*>(ring.beginWrite());
 }
 
-void Renderer::updateWireframe(const std::vector<glm::vec3>& lines) {
-    if (lines == wireframeLines) return;
-    wireframeLines = lines;
-    glBindBuffer(GL_ARRAY_BUFFER, wireframeVBO);
-    glBufferData(GL_ARRAY_BUFFER, lines.size() * sizeof(glm::vec3), lines.data(), GL_DYNAMIC_DRAW);
+void Renderer::bindVertexSource(unsigned int vao, unsigned int buffer) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glBindVertexArray(0);
 }
 
 // --- 2DRender ---
 void Renderer::render() {
-    if (!initialized) return;
+    if (!initialized || !useFlatShader()) return;
 
     // 控制点
-    if (!controlPoints.empty() && pointShader) {
-        pointShader->use();
-        pointShader->setFloat("pointSize", 5.0f);
-        pointShader->setVec4("uColor", 1.0f, 0.5f, 0.0f, 1.0f);
-        glUniformMatrix4fv(glGetUniformLocation(pointShader->ID, "uView"), 1, GL_FALSE, &viewMat[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(pointShader->ID, "uProjection"), 1, GL_FALSE, &projMat[0][0]);
+    if (controlPoints.count > 0) {
+        glUniform1f(pointSizeLocation, 5.0f);
+        setColor(1.0f, 0.5f, 0.0f, 1.0f);
         glBindVertexArray(pointVAO);
-        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(controlPoints.size()));
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(controlPoints.count));
         glBindVertexArray(0);
     }
 
     // 控制多边形
-    if (controlPolygon.size() > 1 && lineShader) {
-        lineShader->use();
-        lineShader->setVec4("uColor", 0.5f, 0.5f, 0.5f, 1.0f);
-        glUniformMatrix4fv(glGetUniformLocation(lineShader->ID, "uView"), 1, GL_FALSE, &viewMat[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(lineShader->ID, "uProjection"), 1, GL_FALSE, &projMat[0][0]);
+    if (controlPolygon.count > 1) {
+        setColor(0.5f, 0.5f, 0.5f, 1.0f);
         glBindVertexArray(polyVAO);
-        glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(controlPolygon.size()));
+        glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(controlPolygon.count));
         glBindVertexArray(0);
     }
 
     // 样条曲线
-    if (curve.size() > 1 && curveShader) {
-        curveShader->use();
-        curveShader->setVec4("uColor", 0.0f, 1.0f, 0.0f, 1.0f);
-        glUniformMatrix4fv(glGetUniformLocation(curveShader->ID, "uView"), 1, GL_FALSE, &viewMat[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(curveShader->ID, "uProjection"), 1, GL_FALSE, &projMat[0][0]);
+    if (curve.count > 1) {
+        setColor(0.0f, 1.0f, 0.0f, 1.0f);
         glBindVertexArray(curveVAO);
-        glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(curve.size()));
+        glDrawArrays(GL_LINE_STRIP, static_cast<GLint>(curve.first), static_cast<GLsizei>(curve.count));
         glBindVertexArray(0);
     }
 }
@@ -238,24 +433,20 @@ void Renderer::render() {
 // --- 3DRender ---
 
 void Renderer::renderAxes() {
-    if (!lineShader) return;
-
-    lineShader->use();
-    glUniformMatrix4fv(glGetUniformLocation(lineShader->ID, "uView"), 1, GL_FALSE, &viewMat[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(lineShader->ID, "uProjection"), 1, GL_FALSE, &projMat[0][0]);
+    if (!useFlatShader()) return;
 
     glBindVertexArray(axesVAO);
 
     // X axis - Red
-    lineShader->setVec4("uColor", 1.0f, 0.0f, 0.0f, 1.0f);
+    setColor(1.0f, 0.0f, 0.0f, 1.0f);
     glDrawArrays(GL_LINES, 0, 2);
 
     // Y axis - Green
-    lineShader->setVec4("uColor", 0.0f, 1.0f, 0.0f, 1.0f);
+    setColor(0.0f, 1.0f, 0.0f, 1.0f);
     glDrawArrays(GL_LINES, 2, 2);
 
     // Z axis - Blue
-    lineShader->setVec4("uColor", 0.0f, 0.0f, 1.0f, 1.0f);
+    setColor(0.0f, 0.0f, 1.0f, 1.0f);
     glDrawArrays(GL_LINES, 4, 2);
 
     glBindVertexArray(0);
@@ -263,45 +454,107 @@ void Renderer::renderAxes() {
 
 
 void Renderer::renderControlPoints() {
-    // 3D模式：只渲染控制点（曲面控制点）
-    if (!controlPoints.empty() && pointShader) {
-        pointShader->use();
-        pointShader->setFloat("pointSize", 5.0f);
-        pointShader->setVec4("uColor", 1.0f, 0.5f, 0.0f, 1.0f);
-        glUniformMatrix4fv(glGetUniformLocation(pointShader->ID, "uView"), 1, GL_FALSE, &viewMat[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(pointShader->ID, "uProjection"), 1, GL_FALSE, &projMat[0][0]);
-        glBindVertexArray(pointVAO);
-        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(controlPoints.size()));
+    // 3D模式：只渲染控制点（曲面控制网格）
+    if (controlNetPoints.count > 0 && useFlatShader()) {
+        glUniform1f(pointSizeLocation, 5.0f);
+        setColor(1.0f, 0.5f, 0.0f, 1.0f);
+        glBindVertexArray(netVAO);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(controlNetPoints.count));
         glBindVertexArray(0);
     }
 }
 
 void Renderer::renderSurface() {
-    if (surfacePositions.empty() || surfaceIndices.empty() || !curveShader) return;
-    if (renderSurfaceAsWireframe) return; // 实心模式才绘制
+    if (surfacePositions.count == 0 || !useFlatShader()) return;
 
-    curveShader->use();
-    glUniformMatrix4fv(glGetUniformLocation(curveShader->ID, "uView"), 1, GL_FALSE, &viewMat[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(curveShader->ID, "uProjection"), 1, GL_FALSE, &projMat[0][0]);
-    curveShader->setVec4("uColor", 0.0f, 0.8f, 1.0f, 0.6f); // 青蓝色半透明
+    bool shaded = surfaceMode != SurfaceRenderMode::Wireframe;
+    bool lines = surfaceMode != SurfaceRenderMode::Shaded;
 
     glBindVertexArray(surfaceVAO);
-    // 注意：EBO 已经在 VAO 中绑定，无需再 bind
-    glDrawElements(GL_TRIANGLES, 
-                   static_cast<GLsizei>(surfaceIndices.size()), 
-                   GL_UNSIGNED_INT, 
-                   (void*)0);
+    // 三角形和线框两套索引共用同一 VAO 的顶点，绘制前绑定各自的 EBO
+    if (shaded && surfaceIndices.count > 0) {
+        setColor(0.0f, 0.8f, 1.0f, 0.6f); // 青蓝色半透明
+        // 等参线画在曲面上：三角形深度稍微后推，避免深度冲突
+        if (lines) {
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(1.0f, 1.0f);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surfaceEBO);
+        drawTopology(surfaceIndices, surfacePositions.first);
+        if (lines) glDisable(GL_POLYGON_OFFSET_FILL);
+    }
+    if (lines && surfaceLineIndices.count > 0) {
+        if (shaded) {
+            setColor(0.0f, 0.3f, 0.5f, 1.0f); // 深蓝色等参线
+        } else {
+            setColor(0.0f, 0.8f, 1.0f, 1.0f); // 青蓝色线框
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surfaceLineEBO);
+        drawTopology(surfaceLineIndices, surfacePositions.first);
+    }
     glBindVertexArray(0);
 }
 
 
 void Renderer::renderWireframe() {
-    if (wireframeLines.empty() || !lineShader) return;
-    lineShader->use();
-    lineShader->setVec4("uColor", 0.0f, 0.0f, 0.0f, 0.8f); // 黑色线框
-    glUniformMatrix4fv(glGetUniformLocation(lineShader->ID, "uView"), 1, GL_FALSE, &viewMat[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(lineShader->ID, "uProjection"), 1, GL_FALSE, &projMat[0][0]);
-    glBindVertexArray(wireframeVAO);
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(wireframeLines.size()));
+    // 控制网格线框：索引直接引用 netVBO 中的控制点
+    if (netIndices.count == 0 || controlNetPoints.count == 0 || !useFlatShader()) return;
+    setColor(0.0f, 0.0f, 0.0f, 0.8f); // 黑色线框
+    glBindVertexArray(netVAO);
+    drawTopology(netIndices, 0);
+    glBindVertexArray(0);
+}
+
+
+// --- ID buffer picking ---
+void Renderer::requestPick(int x, int y, int width, int height, bool includeSurface) {
+    if (!pickShader || !pickBuffer.resize(width, height)) return;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    // 光标不在窗口内时不发起回读，上一次的结果保持不变
+    if (!pickBuffer.begin(x, y)) return;
+    glEnable(GL_DEPTH_TEST);
+    uploadCamera();
+    pickShader->use();
+
+    // 先画曲面只为写入深度和参数，之后被它挡住的控制点通不过深度测试
+    if (includeSurface && surfacePositions.count > 0 && surfaceIndices.count > 0) {
+        glUniform1ui(pickIdBaseLocation, kSurfaceId);
+        glUniform1i(pickVertexIdsLocation, 0);
+        glUniform1i(pickBaseVertexLocation, static_cast<GLint>(surfacePositions.first));
+        glUniform2i(pickGridLocation, surfaceIndices.uSamples, surfaceIndices.vSamples);
+        glBindVertexArray(surfaceVAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surfaceEBO);
+        drawTopology(surfaceIndices, surfacePositions.first);
+    }
+    if (controlNetPoints.count > 0) {
+        glUniform1ui(pickIdBaseLocation, kControlPointIdBase);
+        glUniform1i(pickVertexIdsLocation, 1);
+        glUniform1i(pickBaseVertexLocation, 0);
+        glUniform2i(pickGridLocation, 0, 0);
+        glUniform1f(pickPointSizeLocation, kPickPointSize);
+        glBindVertexArray(netVAO);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(controlNetPoints.count));
+    }
     glBindVertexArray(0);
+
+    pickBuffer.end();
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (!depthTest) glDisable(GL_DEPTH_TEST);
+}
+
+bool Renderer::pollPick(PickResult& result) {
+    PickSample sample;
+    if (!pickBuffer.poll(sample)) return false;
+    result = PickResult();
+    if (sample.id == kSurfaceId) {
+        result.kind = PickResult::Kind::Surface;
+        result.uv = sample.uv;
+    } else if (sample.id >= kControlPointIdBase) {
+        result.kind = PickResult::Kind::ControlPoint;
+        result.index = static_cast<int>(sample.id - kControlPointIdBase);
+    }
+    return true;
 }
@@ -2,6 +2,21 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "control_net.h"
+#include "gpu_buffer.h"
+#include "pick_buffer.h"
+#include "surface_topology.h"
+
+// 曲面显示方式：实体 / 细分线框 / 实体加等参线。线框和等参线只是另一套索引，共用已求值的顶点
+enum class SurfaceRenderMode { Shaded, Wireframe, IsoLines };
+
+// ID 缓冲拾取的结果
+struct PickResult {
+    enum class Kind { None, ControlPoint, Surface };
+    Kind kind = Kind::None;
+    int index = -1;                 // ControlPoint：控制点行优先下标 row * cols + col
+    glm::vec2 uv = glm::vec2(0.0f); // Surface：归一化采样参数，[0,1]² 对应整个采样网格
+};
 
 class Renderer {
 public:
@@ -10,17 +25,54 @@ public:
 
     void renderAxes(); // 渲染 XYZ 坐标轴
 
-    void updateControlPoints(const std::vector<glm::vec3>& points);
-    void updateControlPolygon(const std::vector<glm::vec3>& points);
-    void updateCurve(const std::vector<glm::vec3>& points);
-    void updateSurface(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices); 
-    void setSurfaceRenderMode(bool wireframe);
+    // generation：数据的版本号（见 Spline::Generation）。与该缓冲区上次上传的版本相同时直接返回，
+    // 不做逐元素比较；传 0 表示无版本信息，总是上传。
+    void updateControlPoints(const std::vector<glm::vec3>& points, uint64_t generation = 0);
+    // 3D 曲面控制点：直接上传齐次控制网格，由顶点着色器做透视除法；版本取 net.generation()
+    void updateControlNet(const Spline::ControlNet& net);
+    void updateControlPolygon(const std::vector<glm::vec3>& points, uint64_t generation = 0);
+    void updateCurve(const std::vector<glm::vec3>& points, uint64_t generation = 0);
+    void updateSurface(const std::vector<glm::vec3>& positions, uint64_t generation = 0);
+    // 曲面索引拓扑：与当前已上传的 (uSamples, vSamples, layout) 相同时直接返回，采样数不变就只上传一次
+    void setSurfaceTopology(const Spline::SurfaceTopology& topology);
+    // 局部更新：只上传行优先网格 (rowStride 列) 中 [rowBegin, rowEnd) × [colBegin, colEnd) 的顶点，
+    // 上传后缓冲区的版本记为 generation。局部更新始终写 surfaceVBO（流式段中没有上一版数据）；
+    // 上一版在环形缓冲区中时先整份上传一次，之后的编辑只上传脏矩形
+    // 顶点数与上次上传不同或脏矩形超出网格时回退为 updateSurface 全量上传
+    void updateSurfaceRange(const std::vector<glm::vec3>& positions, int rowStride,
+                            int rowBegin, int rowEnd, int colBegin, int colEnd,
+                            uint64_t generation = 0);
+    void setSurfaceRenderMode(SurfaceRenderMode mode);
+    SurfaceRenderMode surfaceRenderMode() const { return surfaceMode; }
+    // 线框 / 等参线索引（GridLines 布局，lineStride 决定等参线密度），与三角形共用 surfaceVBO 中的顶点
+    void setSurfaceLineTopology(const Spline::SurfaceTopology& topology);
     void renderControlPoints();
     void renderSurface(); // 新增渲染函数
-    void updateWireframe(const std::vector<glm::vec3>& lines);
+    // 控制网格线框的索引（GridLines 布局），直接引用 updateControlNet 上传的控制点；网格尺寸不变时只上传一次
+    void setControlNetTopology(const Spline::SurfaceTopology& topology);
     void renderWireframe();
     void render();
 
+    // 流式上传：上下文支持持久映射（GL 4.4 / ARB_buffer_storage）时，曲线和曲面顶点改走
+    // 三段环形缓冲区，不再重新分配或隐式同步。不支持时返回 false，继续使用按容量增长的 VBO。
+    bool enableStreaming(GLProcLoader loader);
+    bool streamingEnabled() const { return streaming; }
+    // 取得可直接写入 count 个曲线顶点的映射内存，求值函数可把结果直接写在这里；
+    // 未启用流式上传时返回 nullptr。写完后调用 commitCurve
+    glm::vec3* beginCurveWrite(size_t count);
+    void commitCurve(size_t count, uint64_t generation = 0);
+    // 每帧绘制命令提交之后调用：为本帧读取的环形缓冲区段插入 fence
+    void endFrame();
+
+    // ID 缓冲拾取（CPU 射线求交之外的另一条路径）：把 3D 控制点及可选的曲面三角形画进离屏整数 ID 缓冲，
+    // 只回读光标下的一个像素。回读经 PBO 异步完成，结果晚 1～2 帧由 pollPick 取得，不会让管线停顿；
+    // 代价与控制点数无关，且被曲面挡住的控制点不会被拾取。pick 着色器加载失败时不可用
+    bool idPickingAvailable() const { return pickShader != nullptr; }
+    // (x, y) 为光标的像素坐标（左上角为原点），width × height 为帧缓冲大小；在本帧数据上传之后调用
+    void requestPick(int x, int y, int width, int height, bool includeSurface);
+    // 有新结果时写入 result 并返回 true，从不阻塞
+    bool pollPick(PickResult& result);
+
     // 设置正交投影（2D 模式）
     void setOrtho(float left, float right, float bottom, float top);
     void setViewMatrix(const glm::mat4& view);
@@ -33,25 +85,76 @@ private:
     unsigned int curveVAO = 0, curveVBO = 0;
     unsigned int axesVAO, axesVBO;
     unsigned int gridVAO = 0, gridVBO = 0;
-    unsigned int surfaceVAO = 0, surfaceVBO = 0, surfaceEBO = 0;
-    unsigned int wireframeVAO = 0, wireframeVBO = 0;
+    unsigned int surfaceVAO = 0, surfaceVBO = 0, surfaceEBO = 0, surfaceLineEBO = 0;
+    unsigned int netVAO = 0, netVBO = 0, netEBO = 0;
+
+    // 各缓冲区当前内容的版本、元素个数与容量（数据本身只保存在 GPU 上）
+    struct UploadedBuffer {
+        uint64_t generation = 0;
+        size_t count = 0;
+        size_t capacity = 0; // VBO 已分配字节数
+        size_t first = 0;    // 首个顶点在缓冲区中的下标（流式上传时为当前段的起点）
+
+        // 版本相同则无需上传；否则记录新版本并返回 true
+        bool update(uint64_t newGeneration, size_t newCount) {
+            if (newGeneration != 0 && newGeneration == generation && newCount == count) return false;
+            generation = newGeneration;
+            count = newCount;
+            return true;
+        }
+    };
+    UploadedBuffer controlPoints, controlPolygon, curve;
+    UploadedBuffer surfacePositions;   // 顶点位置（不重复，M×N 个）
+    UploadedBuffer controlNetPoints;
+
+    // 已上传的索引拓扑，以 (uSamples, vSamples, layout) 为键
+    struct UploadedTopology {
+        int uSamples = -1, vSamples = -1;
+        Spline::IndexLayout layout = Spline::IndexLayout::Triangles;
+        int lineStride = 1;
+        bool compact = false; // 16 位索引
+        size_t count = 0;
+        size_t capacity = 0;  // EBO 已分配字节数
+    };
+    UploadedTopology surfaceIndices;   // 三角形列表或带重启索引的三角形带
+    UploadedTopology surfaceLineIndices; // 曲面线框 / 等参线
+    UploadedTopology netIndices;       // 控制网格线框
+    // 键与已上传的相同时直接返回，否则上传到 vao 所绑定的 ebo
+    void uploadTopology(UploadedTopology& state, unsigned int vao, unsigned int ebo,
+                        const Spline::SurfaceTopology& topology);
+    // 按布局选择图元类型、索引类型和图元重启；调用前绑定对应的 VAO
+    void drawTopology(const UploadedTopology& state, size_t baseVertex);
+
+    // 段容量不足时重建环形缓冲区并把 vao 的顶点属性指向它；失败时两路都退回 VBO 并关闭流式上传
+    glm::vec3* beginStream(StreamRingBuffer& ring, unsigned int vao, size_t count);
+    void bindVertexSource(unsigned int vao, unsigned int buffer);
+    bool streaming = false;
+    StreamRingBuffer curveStream, surfaceStream;
+    bool surfaceStreamBound = false; // surfaceVAO 当前从 surfaceStream 取顶点，否则从 surfaceVBO
 
-    // CPU 数据缓存（用于脏检查）
-    std::vector<glm::vec3> controlPoints, controlPolygon, curve;
-    std::vector<glm::vec3> surfacePositions;   // 顶点位置（不重复，M×N 个）
-    std::vector<unsigned int> surfaceIndices;  // 索引列表（三角形索引）
-    std::vector<glm::vec3> wireframeLines;
+    // 着色器：点、线、曲面都只需要纯色，共用一个程序；uniform 位置在链接后查询一次
+    class Shader* flatShader = nullptr;
+    int colorLocation = -1;
+    int pointSizeLocation = -1;
+    // 切换到纯色程序并在需要时上传相机矩阵；着色器加载失败时返回 false
+    bool useFlatShader();
+    void setColor(float r, float g, float b, float a);
+    // cameraDirty 时把相机矩阵写入 cameraUBO
+    void uploadCamera();
 
-    // 着色器
-    class Shader* pointShader = nullptr;
-    class Shader* lineShader = nullptr;
-    class Shader* curveShader = nullptr;
+    // ID 缓冲拾取
+    class Shader* pickShader = nullptr;
+    int pickPointSizeLocation = -1, pickBaseVertexLocation = -1, pickGridLocation = -1;
+    int pickIdBaseLocation = -1, pickVertexIdsLocation = -1;
+    PickBuffer pickBuffer;
 
-    // 相机矩阵（2D 使用正交）
+    // 相机矩阵（2D 使用正交），存放在 std140 uniform 缓冲区：[0] = view，[1] = projection。
+    // set* 只记录修改，下一次绘制前统一上传
     glm::mat4 viewMat;
     glm::mat4 projMat;
+    unsigned int cameraUBO = 0;
+    bool cameraDirty = true;
 
     bool initialized = false;
-    // 渲染模式：true = 线框，false = 实体
-    bool renderSurfaceAsWireframe = false;
+    SurfaceRenderMode surfaceMode = SurfaceRenderMode::Shaded;
 };
\ No newline at end of file
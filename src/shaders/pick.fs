@@ -0,0 +1,14 @@
+#version 330 core
+flat in uint vIndex;
+in vec2 vUV;
+
+uniform uint uIdBase;     // 物体 ID；uVertexIds 为真时再加上顶点下标
+uniform bool uVertexIds;
+
+layout (location = 0) out uint outId;
+layout (location = 1) out vec2 outUV;
+
+void main() {
+    outId = uVertexIds ? uIdBase + vIndex : uIdBase;
+    outUV = vUV;
+}
@@ -0,0 +1,25 @@
+#version 330 core
+layout (location = 0) in vec4 aPos;
+
+layout (std140) uniform Camera {
+    mat4 uView;
+    mat4 uProjection;
+};
+uniform float pointSize;
+uniform int uBaseVertex; // glDrawElementsBaseVertex 的基顶点会计入 gl_VertexID，这里减掉
+uniform ivec2 uGrid;     // 曲面采样数 (uSamples, vSamples)；为 0 时不输出参数
+
+flat out uint vIndex;
+out vec2 vUV;
+
+void main() {
+    gl_Position = uProjection * uView * vec4(aPos.xyz / aPos.w, 1.0);
+    gl_PointSize = pointSize;
+
+    int index = gl_VertexID - uBaseVertex;
+    vIndex = uint(index);
+    // 行优先采样网格：第 i 行对应 u = i / uSamples，第 j 列对应 v = j / vSamples
+    vUV = all(greaterThan(uGrid, ivec2(0)))
+        ? vec2(index / (uGrid.y + 1), index % (uGrid.y + 1)) / vec2(uGrid)
+        : vec2(0.0);
+}
@@ -1,11 +1,14 @@
 #version 330 core
-layout (location = 0) in vec3 aPos; 
+layout (location = 0) in vec4 aPos; // 3 分量属性的 w 默认为 1；齐次控制点在此做透视除法
 
-uniform mat4 uView;
-uniform mat4 uProjection;
+// 所有程序共享的相机矩阵（std140，绑定点 0），每帧由 Renderer 更新一次
+layout (std140) uniform Camera {
+    mat4 uView;
+    mat4 uProjection;
+};
 uniform float pointSize;
 
 void main() {
-    gl_Position = uProjection * uView * vec4(aPos, 1.0);
+    gl_Position = uProjection * uView * vec4(aPos.xyz / aPos.w, 1.0);
     gl_PointSize = pointSize;
 }
\ No newline at end of file
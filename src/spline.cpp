@@ -1,71 +1,215 @@
 #include "spline.h"
+#include "power_basis.h"
+#include "spline_fixed.h"
+#include "spline_simd.h"
+#include "frame_arena.h"
 #include <cassert>
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 
 namespace Spline {
 
 // ========================
-// 1. Bezier Curve (de Casteljau)
+// 1. Bezier Curve
 // ========================
-std::vector<glm::vec3> evaluateBezier(const std::vector<glm::vec3>& controlPoints, int numSamples) {
-    std::vector<glm::vec3> curve;
-    if (controlPoints.empty()) return curve;
-    if (controlPoints.size() == 1) {
-        curve.push_back(controlPoints[0]);
-        return curve;
+namespace {
+
+// 超过该次数时 Horner 中的二项式系数与 (1-t)^n 接近 double 的表示范围，改用自适应细分
+constexpr int kBezierHornerMaxDegree = 512;
+
+// O(n) Horner 求值（double 精度）：
+// C(t) = sum C(n,k) t^k (1-t)^(n-k) P_k，二项式系数逐项递推，不经过 int。
+// t > 0.5 时反向遍历控制点并用 1-t 代替 t，保证 t^k·C(n,k) 有界。
+glm::vec3 evaluateBezierHorner(const std::vector<glm::vec3>& controlPoints, double t) {
+    int n = static_cast<int>(controlPoints.size()) - 1;
+    bool reversed = t > 0.5;
+    if (reversed) t = 1.0 - t;
+    auto point = [&](int k) { return glm::dvec3(controlPoints[reversed ? n - k : k]); };
+
+    double s = 1.0 - t;
+    double tn = 1.0;   // t^k
+    double coeff = 1.0; // C(n, k)
+    glm::dvec3 acc = point(0) * s;
+    for (int k = 1; k < n; ++k) {
+        tn *= t;
+        coeff = coeff * (n - k + 1) / k;
+        acc = (acc + tn * coeff * point(k)) * s;
     }
+    acc += tn * t * point(n);
+    return glm::vec3(acc);
+}
 
-    for (int i = 0; i <= numSamples; ++i) {
-        float t = static_cast<float>(i) / numSamples;
-        std::vector<glm::vec3> temp = controlPoints;
+// de Casteljau 细分工作区：每层递归一份片段与右半段缓冲，跨调用复用容量
+struct BezierScratch {
+    std::vector<std::vector<glm::dvec3>> pieces;
+    std::vector<std::vector<glm::dvec3>> rights;
+};
 
-        // de Casteljau 递归
-        for (size_t level = 1; level < controlPoints.size(); ++level) {
-            for (size_t j = 0; j < controlPoints.size() - level; ++j) {
-                temp[j] = (1.0f - t) * temp[j] + t * temp[j + 1];
-            }
+BezierScratch& bezierScratch() {
+    thread_local BezierScratch scratch;
+    return scratch;
+}
+
+// 在 t = 0.5 处细分：piece 原地变为左半段，right 为右半段
+void splitBezierHalf(std::vector<glm::dvec3>& piece, std::vector<glm::dvec3>& right) {
+    size_t n = piece.size() - 1;
+    right.resize(n + 1);
+    right[n] = piece[n];
+    for (size_t level = 1; level <= n; ++level) {
+        for (size_t j = n; j >= level; --j) {
+            piece[j] = 0.5 * (piece[j - 1] + piece[j]);
+        }
+        right[n - level] = piece[n];
+    }
+}
+
+// 控制多边形到弦的最大距离不超过 tolerance 时视为平直
+bool isBezierFlat(const std::vector<glm::dvec3>& piece, double tolerance) {
+    glm::dvec3 a = piece.front();
+    glm::dvec3 chord = piece.back() - a;
+    double len2 = glm::dot(chord, chord);
+    for (size_t k = 1; k + 1 < piece.size(); ++k) {
+        glm::dvec3 d = piece[k] - a;
+        if (len2 > 0.0) d -= chord * (glm::dot(d, chord) / len2);
+        if (glm::dot(d, d) > tolerance * tolerance) return false;
+    }
+    return true;
+}
+
+// 极高次曲线：递归二分 pieces[depth] 直到平直或达到采样分辨率，
+// 输出各片段起点（细分点精确位于曲线上）
+void subdivideBezierAdaptive(BezierScratch& scratch, int depth, int maxDepth, double tolerance,
+                             glm::vec3* out, size_t& count) {
+    const std::vector<glm::dvec3>& piece = scratch.pieces[depth];
+    if (depth == maxDepth || isBezierFlat(piece, tolerance)) {
+        out[count++] = glm::vec3(piece.front());
+        return;
+    }
+    std::vector<glm::dvec3>& child = scratch.pieces[depth + 1];
+    child.assign(piece.begin(), piece.end());
+    splitBezierHalf(child, scratch.rights[depth]);
+    subdivideBezierAdaptive(scratch, depth + 1, maxDepth, tolerance, out, count);
+    child.swap(scratch.rights[depth]);
+    subdivideBezierAdaptive(scratch, depth + 1, maxDepth, tolerance, out, count);
+}
+
+// 自适应细分的最大递归深度：2^depth >= numSamples
+int bezierSubdivisionDepth(int numSamples) {
+    int depth = 0;
+    while ((1 << depth) < numSamples) ++depth;
+    return depth;
+}
+
+} // namespace
+
+size_t bezierOutputSize(int numControlPoints, int numSamples) {
+    if (numControlPoints <= 0) return 0;
+    if (numControlPoints == 1 || numSamples < 1) return 1;
+    if (numControlPoints - 1 <= kBezierHornerMaxDegree) return static_cast<size_t>(numSamples) + 1;
+    return (static_cast<size_t>(1) << bezierSubdivisionDepth(numSamples)) + 1;
+}
+
+size_t evaluateBezier(const std::vector<glm::vec3>& controlPoints, int numSamples,
+                      glm::vec3* out, size_t capacity) {
+    if (capacity < bezierOutputSize(static_cast<int>(controlPoints.size()), numSamples)) return 0;
+    if (controlPoints.empty()) return 0;
+    if (controlPoints.size() == 1 || numSamples < 1) {
+        out[0] = controlPoints[0];
+        return 1;
+    }
+
+    int degree = static_cast<int>(controlPoints.size()) - 1;
+    if (degree <= kBezierHornerMaxDegree) {
+        for (int i = 0; i <= numSamples; ++i) {
+            double t = static_cast<double>(i) / numSamples;
+            out[i] = evaluateBezierHorner(controlPoints, t);
         }
-        curve.push_back(temp[0]);
+        return static_cast<size_t>(numSamples) + 1;
+    }
+
+    // 自适应细分：最多细分到 numSamples 的分辨率，平直片段提前停止
+    int maxDepth = bezierSubdivisionDepth(numSamples);
+    glm::vec3 lo = controlPoints[0], hi = controlPoints[0];
+    for (const auto& p : controlPoints) {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    double tolerance = 1e-4 * glm::length(glm::dvec3(hi - lo));
+
+    BezierScratch& scratch = bezierScratch();
+    if (scratch.pieces.size() < static_cast<size_t>(maxDepth + 1)) {
+        scratch.pieces.resize(maxDepth + 1);
+        scratch.rights.resize(maxDepth + 1);
     }
+    scratch.pieces[0].assign(controlPoints.begin(), controlPoints.end());
+    size_t count = 0;
+    subdivideBezierAdaptive(scratch, 0, maxDepth, tolerance, out, count);
+    out[count++] = controlPoints.back();
+    return count;
+}
+
+std::vector<glm::vec3> evaluateBezier(const std::vector<glm::vec3>& controlPoints, int numSamples) {
+    std::vector<glm::vec3> curve(bezierOutputSize(static_cast<int>(controlPoints.size()), numSamples));
+    curve.resize(evaluateBezier(controlPoints, numSamples, curve.data(), curve.size()));
     return curve;
 }
 
 // ========================
-// 2. Cox-de Boor Basis Function (recursive)
+// 2. B-Spline Basis Engine
 // ========================
-float coxDeBoor(int i, int k, float u, const std::vector<float>& knots) {
-    if (k == 0) {
-        if (u >= knots[i] && u < knots[i + 1]) return 1.0f;
-        // Handle last point
-        if (u == knots.back() && i == static_cast<int>(knots.size()) - 2) return 1.0f;
-        return 0.0f;
-    }
+// 二分查找节点区间：返回 span，使 knots[span] <= u < knots[span + 1]。
+// u 位于参数域末端时返回最后一个非空区间 n，保证端点插值。
+int findKnotSpan(int numControlPoints, int degree, float u, const float* knots) {
+    int n = numControlPoints - 1;
+    if (u >= knots[n + 1]) return n;
+    if (u <= knots[degree]) return degree;
 
-    float denom1 = knots[i + k] - knots[i];
-    float term1 = 0.0f;
-    if (denom1 > 1e-6f) {
-        term1 = ((u - knots[i]) / denom1) * coxDeBoor(i, k - 1, u, knots);
+    int low = degree;
+    int high = n + 1;
+    int mid = (low + high) / 2;
+    while (u < knots[mid] || u >= knots[mid + 1]) {
+        if (u < knots[mid]) high = mid;
+        else low = mid;
+        mid = (low + high) / 2;
     }
+    return mid;
+}
+
+int findKnotSpan(int numControlPoints, int degree, float u, const std::vector<float>& knots) {
+    return findKnotSpan(numControlPoints, degree, u, knots.data());
+}
 
-    float denom2 = knots[i + k + 1] - knots[i + 1];
-    float term2 = 0.0f;
-    if (denom2 > 1e-6f) {
-        term2 = ((knots[i + k + 1] - u) / denom2) * coxDeBoor(i + 1, k - 1, u, knots);
+// 三角递推计算 span 上 p+1 个非零基函数 N[span-p .. span]，写入 N[0..p]。
+// left/right 直接由节点差给出，无需额外缓冲区。
+void basisFunctions(int span, float u, int degree, const float* knots, float* N) {
+    N[0] = 1.0f;
+    for (int j = 1; j <= degree; ++j) {
+        float saved = 0.0f;
+        for (int r = 0; r < j; ++r) {
+            float right = knots[span + r + 1] - u;
+            float left = u - knots[span + 1 + r - j];
+            float temp = N[r] / (right + left);
+            N[r] = saved + right * temp;
+            saved = left * temp;
+        }
+        N[j] = saved;
     }
+}
 
-    return term1 + term2;
+void basisFunctions(int span, float u, int degree, const std::vector<float>& knots, float* N) {
+    basisFunctions(span, u, degree, knots.data(), N);
 }
 
-// Helper: generate clamped uniform knot vector
-std::vector<float> generateClampedKnotVector(int numControlPoints, int degree) {
-    if (numControlPoints <= 0 || degree < 1) {
-        return {0.0f, 1.0f}; // fallback
-    }
+namespace {
+
+// 写入 numControlPoints + degree + 1 个钳位均匀节点（要求 numControlPoints >= 1, degree >= 1）
+void fillClampedKnots(int numControlPoints, int degree, float* knots) {
     int p = degree;
     int numKnots = numControlPoints + p + 1;
-    std::vector<float> knots(numKnots, 0.0f);
+    std::fill(knots, knots + numKnots, 0.0f);
 
     for (int i = 0; i <= p; ++i) {
         knots[i] = 0.0f;
@@ -78,255 +222,621 @@ std::vector<float> generateClampedKnotVector(int numControlPoints, int degree) {
             knots[p + 1 + i] = static_cast<float>(i + 1) / static_cast<float>(numInterior + 1);
         }
     }
+}
+
+// 求值函数内部使用的临时节点向量，内存取自 scratchResource()
+std::pmr::vector<float> scratchKnotVector(int numControlPoints, int degree) {
+    std::pmr::vector<float> knots(numControlPoints + degree + 1, scratchResource());
+    fillClampedKnots(numControlPoints, degree, knots.data());
+    return knots;
+}
+
+} // namespace
+
+// Helper: generate clamped uniform knot vector
+std::vector<float> generateClampedKnotVector(int numControlPoints, int degree) {
+    if (numControlPoints <= 0 || degree < 1) {
+        return {0.0f, 1.0f}; // fallback
+    }
+    std::vector<float> knots(numControlPoints + degree + 1);
+    fillClampedKnots(numControlPoints, degree, knots.data());
     return knots;
 }
+BasisTable buildBasisTable(int numControlPoints, int degree, int numSamples) {
+    BasisTable table;
+    if (numControlPoints <= 0 || numSamples < 0) return table;
+    int count = numSamples + 1;
+
+    if (degree > numControlPoints - 1) degree = numControlPoints - 1;
+    if (degree < 1) {
+        table.order = 1;
+        table.first.assign(count, 0);
+        table.values.assign(count, 1.0f);
+        return table;
+    }
+
+    auto knots = scratchKnotVector(numControlPoints, degree);
+    table.order = degree + 1;
+    table.first.resize(count);
+    table.values.resize(static_cast<size_t>(count) * table.order);
+    if (dispatchDegree(degree, [&](auto P) {
+            fillBasisTableFixed<decltype(P)::value>(numControlPoints, knots.data(), numSamples,
+                                                    table.first.data(), table.values.data());
+        })) {
+        return table;
+    }
+    for (int s = 0; s < count; ++s) {
+        float u = numSamples > 0 ? static_cast<float>(s) / numSamples : 0.0f;
+        int span = findKnotSpan(numControlPoints, degree, u, knots.data());
+        basisFunctions(span, u, degree, knots.data(), &table.values[static_cast<size_t>(s) * table.order]);
+        table.first[s] = span - degree;
+    }
+    return table;
+}
+
 // ========================
 // 3. B-Spline Curve
 // ========================
-std::vector<glm::vec3> evaluateBSpline(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples) {
-    std::vector<glm::vec3> curve;
-    size_t n = controlPoints.size();
-    if (n == 0) return curve;
-    if (degree >= static_cast<int>(n)) degree = static_cast<int>(n) - 1;
+size_t bsplineOutputSize(int numControlPoints, int degree, int numSamples) {
+    if (numControlPoints <= 0) return 0;
+    if (degree >= numControlPoints) degree = numControlPoints - 1;
+    if (degree < 1) return static_cast<size_t>(numControlPoints);
+    return static_cast<size_t>(std::max(numSamples, 0)) + 1;
+}
+
+namespace {
+
+// 较高次数的密集采样交给 SIMD 批量内核；标量级别下批量内核没有优势
+bool shouldUseBatchKernel(int degree, int numSamples) {
+    return degree >= kSimdBatchMinDegree && numSamples >= kSimdBatchMinSamples && getSimdLevel() != SimdLevel::Scalar;
+}
+
+// 批量内核求值 [0, 1) 上的 numSamples 个采样，写入 out[0..numSamples)；weights 为空时为多项式曲线
+void evaluateCurveBatched(const std::vector<glm::vec3>& controlPoints, const std::vector<float>& weights,
+                          int degree, int numSamples, glm::vec3* out) {
+    thread_local ControlPointsSoA soa;
+    toSoA(controlPoints, weights, soa);
+    auto knots = generateClampedKnotVector(static_cast<int>(controlPoints.size()), degree);
+    std::pmr::vector<float> params(numSamples, scratchResource());
+    for (int s = 0; s < numSamples; ++s) params[s] = static_cast<float>(s) / numSamples;
+    evaluateCurveBatch(soa, degree, knots, !weights.empty(), params.data(), numSamples, out);
+}
+
+// cache 为空时幂基形式只用于本次调用
+size_t evaluateBSplineImpl(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples,
+                           PowerBasisCache* cache, uint64_t pointsGeneration,
+                           glm::vec3* out, size_t capacity) {
+    int n = static_cast<int>(controlPoints.size());
+    size_t count = bsplineOutputSize(n, degree, numSamples);
+    if (count == 0 || capacity < count) return 0;
+    if (degree >= n) degree = n - 1;
     if (degree < 1) {
-        return controlPoints;
+        std::copy(controlPoints.begin(), controlPoints.end(), out);
+        return count;
+    }
+
+    // 密集采样：逐区间转为幂基多项式后用 Horner 求值
+    if (shouldUsePowerBasis(n, degree, numSamples)) {
+        PowerBasisCache local;
+        const PowerBasisCurve& curve =
+            getPowerBasisCurve(cache ? *cache : local, controlPoints, {}, degree, pointsGeneration, 0);
+        evaluatePowerBasisCurve(curve, numSamples, out, capacity);
+        out[numSamples] = controlPoints.back();
+        return count;
+    }
+
+    if (shouldUseBatchKernel(degree, numSamples)) {
+        evaluateCurveBatched(controlPoints, {}, degree, numSamples, out);
+        out[numSamples] = controlPoints.back();
+        return count;
+    }
+
+    auto knots = scratchKnotVector(n, degree);
+
+    // 常用低次：定长内核
+    if (numSamples > 0 && degree <= kMaxFixedDegree) {
+        dispatchDegree(degree, [&](auto P) {
+            evaluateCurveFixed<decltype(P)::value>(controlPoints.data(), nullptr, n,
+                                                   knots.data(), numSamples, out);
+        });
+        out[numSamples] = controlPoints.back();
+        return count;
     }
 
-    auto knots = generateClampedKnotVector(static_cast<int>(n), degree);
+    std::pmr::vector<float> N(degree + 1, scratchResource());
 
     // 采样 [0, 1)
     for (int s = 0; s < numSamples; ++s) {
         float u = static_cast<float>(s) / numSamples;
+        int span = findKnotSpan(n, degree, u, knots.data());
+        basisFunctions(span, u, degree, knots.data(), N.data());
         glm::vec3 pt(0.0f);
-        for (size_t i = 0; i < n; ++i) {
-            float basis = coxDeBoor(static_cast<int>(i), degree, u, knots);
-            pt += basis * controlPoints[i];
+        for (int a = 0; a <= degree; ++a) {
+            pt += N[a] * controlPoints[span - degree + a];
         }
-        curve.push_back(pt);
+        out[s] = pt;
     }
 
     // 添加终点
-    curve.push_back(controlPoints.back());
+    out[count - 1] = controlPoints.back();
+    return count;
+}
+
+} // namespace
+
+size_t evaluateBSpline(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples,
+                       glm::vec3* out, size_t capacity) {
+    return evaluateBSplineImpl(controlPoints, degree, numSamples, nullptr, 0, out, capacity);
+}
+
+size_t evaluateBSpline(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples,
+                       PowerBasisCache& cache, uint64_t pointsGeneration,
+                       glm::vec3* out, size_t capacity) {
+    return evaluateBSplineImpl(controlPoints, degree, numSamples, &cache, pointsGeneration, out, capacity);
+}
+
+std::vector<glm::vec3> evaluateBSpline(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples) {
+    std::vector<glm::vec3> curve(bsplineOutputSize(static_cast<int>(controlPoints.size()), degree, numSamples));
+    evaluateBSpline(controlPoints, degree, numSamples, curve.data(), curve.size());
     return curve;
 }
 
 // ========================
 // 4. NURBS Curve
 // ========================
-std::vector<glm::vec3> evaluateNURBS(const std::vector<glm::vec3>& controlPoints,
-                                     const std::vector<float>& weights,
-                                     int degree,
-                                     int numSamples) {
+namespace {
+
+size_t evaluateNURBSImpl(const std::vector<glm::vec3>& controlPoints,
+                         const std::vector<float>& weights,
+                         int degree, int numSamples,
+                         PowerBasisCache* cache, uint64_t pointsGeneration, uint64_t weightsGeneration,
+                         glm::vec3* out, size_t capacity) {
     assert(controlPoints.size() == weights.size());
-    std::vector<glm::vec3> curve;
-    size_t n = controlPoints.size();
-    if (n == 0) return curve;
-    if (degree >= static_cast<int>(n)) degree = static_cast<int>(n) - 1;
+    int n = static_cast<int>(controlPoints.size());
+    size_t count = bsplineOutputSize(n, degree, numSamples);
+    if (count == 0 || capacity < count) return 0;
+    if (degree >= n) degree = n - 1;
     if (degree < 1) {
-        return controlPoints;
+        std::copy(controlPoints.begin(), controlPoints.end(), out);
+        return count;
+    }
+
+    // 权重全为正时分母不会退化，幂基与批量内核的结果与下面的逐点求值一致
+    bool positiveWeights = std::all_of(weights.begin(), weights.end(), [](float w) { return w > 0.0f; });
+
+    // 密集采样时走幂基 Horner 路径
+    if (positiveWeights && shouldUsePowerBasis(n, degree, numSamples)) {
+        PowerBasisCache local;
+        const PowerBasisCurve& curve = getPowerBasisCurve(cache ? *cache : local, controlPoints, weights, degree,
+                                                          pointsGeneration, weightsGeneration);
+        evaluatePowerBasisCurve(curve, numSamples, out, capacity);
+        out[numSamples] = controlPoints.back();
+        return count;
+    }
+
+    if (positiveWeights && shouldUseBatchKernel(degree, numSamples)) {
+        evaluateCurveBatched(controlPoints, weights, degree, numSamples, out);
+        out[numSamples] = controlPoints.back();
+        return count;
     }
 
-    auto knots = generateClampedKnotVector(static_cast<int>(n), degree);
+    auto knots = scratchKnotVector(n, degree);
+
+    // 常用低次：定长内核
+    if (numSamples > 0 && degree <= kMaxFixedDegree) {
+        dispatchDegree(degree, [&](auto P) {
+            evaluateCurveFixed<decltype(P)::value>(controlPoints.data(), weights.data(), n,
+                                                   knots.data(), numSamples, out);
+        });
+        out[numSamples] = controlPoints.back();
+        return count;
+    }
+
+    std::pmr::vector<float> N(degree + 1, scratchResource());
 
     for (int s = 0; s < numSamples; ++s) {
         float u = static_cast<float>(s) / numSamples;
+        int span = findKnotSpan(n, degree, u, knots.data());
+        basisFunctions(span, u, degree, knots.data(), N.data());
+        int first = span - degree;
+
         float denominator = 0.0f;
         glm::vec3 numerator(0.0f);
-        for (size_t i = 0; i < n; ++i) {
-            float basis = coxDeBoor(static_cast<int>(i), degree, u, knots);
-            float w = weights[i];
-            numerator += w * basis * controlPoints[i];
-            denominator += w * basis;
+        for (int a = 0; a <= degree; ++a) {
+            float w = weights[first + a];
+            numerator += w * N[a] * controlPoints[first + a];
+            denominator += w * N[a];
         }
         if (std::abs(denominator) > 1e-6f) {
-            curve.push_back(numerator / denominator);
+            out[s] = numerator / denominator;
         } else {
             glm::vec3 pt(0.0f);
-            for (size_t i = 0; i < n; ++i) {
-                float basis = coxDeBoor(static_cast<int>(i), degree, u, knots);
-                pt += basis * controlPoints[i];
+            for (int a = 0; a <= degree; ++a) {
+                pt += N[a] * controlPoints[first + a];
             }
-            curve.push_back(pt);
+            out[s] = pt;
         }
     }
 
     // 添加终点
-    curve.push_back(controlPoints.back());
+    out[count - 1] = controlPoints.back();
+    return count;
+}
+
+} // namespace
+
+size_t evaluateNURBS(const std::vector<glm::vec3>& controlPoints,
+                     const std::vector<float>& weights,
+                     int degree, int numSamples,
+                     glm::vec3* out, size_t capacity) {
+    return evaluateNURBSImpl(controlPoints, weights, degree, numSamples, nullptr, 0, 0, out, capacity);
+}
+
+size_t evaluateNURBS(const std::vector<glm::vec3>& controlPoints,
+                     const std::vector<float>& weights,
+                     int degree, int numSamples,
+                     PowerBasisCache& cache, uint64_t pointsGeneration, uint64_t weightsGeneration,
+                     glm::vec3* out, size_t capacity) {
+    return evaluateNURBSImpl(controlPoints, weights, degree, numSamples, &cache, pointsGeneration,
+                             weightsGeneration, out, capacity);
+}
+
+std::vector<glm::vec3> evaluateNURBS(const std::vector<glm::vec3>& controlPoints,
+                                     const std::vector<float>& weights,
+                                     int degree,
+                                     int numSamples) {
+    std::vector<glm::vec3> curve(bsplineOutputSize(static_cast<int>(controlPoints.size()), degree, numSamples));
+    evaluateNURBS(controlPoints, weights, degree, numSamples, curve.data(), curve.size());
     return curve;
 }
 
 
+// ========================
+// 张量积曲面：可分离两遍求值
+// ========================
+namespace {
+
+// 第一遍：沿 u 把每一列收缩为中间点（齐次坐标，按 u 采样行优先存放）。
+// points 为行优先、行步长 rowStride 的齐次控制点，内层沿 v 为步长 1 的顺序访问。
+// ORDER > 0 时基函数个数为编译期常量，内层循环可展开；ORDER = 0 使用表中的运行时阶数。
+template <int ORDER>
+void tensorFirstPass(const glm::vec4* points, size_t rowStride, size_t cols,
+                     const BasisTable& bu, std::vector<glm::vec4>& intermediate) {
+    const int order = ORDER > 0 ? ORDER : bu.order;
+    size_t numU = bu.first.size();
+    intermediate.assign(numU * cols, glm::vec4(0.0f));
+    for (size_t i = 0; i < numU; ++i) {
+        glm::vec4* q = &intermediate[i * cols];
+        for (int a = 0; a < order; ++a) {
+            float c = bu.values[i * order + a];
+            const glm::vec4* row = points + static_cast<size_t>(bu.first[i] + a) * rowStride;
+            for (size_t l = 0; l < cols; ++l) q[l] += c * row[l];
+        }
+    }
+}
+
+// 第二遍：对每个 u 采样沿 v 求值中间曲线
+template <int ORDER>
+void tensorSecondPass(const ControlNet& net, bool rational,
+                      const BasisTable& bu, const BasisTable& bv,
+                      const std::vector<glm::vec4>& intermediate, glm::vec3* surfacePoints) {
+    const int order = ORDER > 0 ? ORDER : bv.order;
+    size_t numU = bu.first.size();
+    size_t numV = bv.first.size();
+    size_t cols = static_cast<size_t>(net.cols);
+    for (size_t i = 0; i < numU; ++i) {
+        const glm::vec4* q = &intermediate[i * cols];
+        for (size_t j = 0; j < numV; ++j) {
+            const float* Nv = &bv.values[j * order];
+            const glm::vec4* qj = q + bv.first[j];
+            glm::vec4 h(0.0f);
+            if constexpr (ORDER > 0) {
+                h = weightedSumFixed<ORDER>(Nv, qj);
+            } else {
+                for (int b = 0; b < order; ++b) h += Nv[b] * qj[b];
+            }
+
+            if (!rational) {
+                surfacePoints[i * numV + j] = glm::vec3(h);
+            } else if (std::abs(h.w) > 1e-6f) {
+                surfacePoints[i * numV + j] = glm::vec3(h) / h.w;
+            } else {
+                // 退化情况，使用普通B样条
+                glm::vec3 point(0.0f);
+                for (int a = 0; a < bu.order; ++a) {
+                    int row = bu.first[i] + a;
+                    for (int b = 0; b < order; ++b) {
+                        point += bu.values[i * bu.order + a] * Nv[b] * net.point(row, bv.first[j] + b);
+                    }
+                }
+                surfacePoints[i * numV + j] = point;
+            }
+        }
+    }
+}
+
+// 可分离两遍求值，代价 O(U·cols·(p+1) + U·V·(q+1))，结果写入 surfacePoints[0..U·V)。
+// rational = false 时按多项式曲面处理。两个方向的次数分别分派到定长实现。
+// 笛卡尔投影与中间缓冲为线程局部，跨调用复用容量。
+void evaluateTensorSurface(const ControlNet& net, bool rational,
+                           const BasisTable& bu, const BasisTable& bv, glm::vec3* surfacePoints) {
+    if (bu.first.empty() || bv.first.empty()) return;
+
+    // 多项式曲面忽略网格中的权重：整个网格先投影为笛卡尔坐标（w = 1）一次，第一遍只做加权求和
+    thread_local std::vector<glm::vec4> cartesian;
+    const glm::vec4* points = net.points.data();
+    if (!rational) {
+        cartesian.resize(net.points.size());
+        for (size_t k = 0; k < net.points.size(); ++k) {
+            const glm::vec4& h = net.points[k];
+            cartesian[k] = glm::vec4(h.w != 0.0f ? glm::vec3(h) / h.w : glm::vec3(h), 1.0f);
+        }
+        points = cartesian.data();
+    }
+
+    thread_local std::vector<glm::vec4> intermediate;
+    size_t cols = static_cast<size_t>(net.cols);
+    if (!dispatchDegree(bu.order - 1, [&](auto P) {
+            tensorFirstPass<decltype(P)::value + 1>(points, net.rowStride, cols, bu, intermediate);
+        })) {
+        tensorFirstPass<0>(points, net.rowStride, cols, bu, intermediate);
+    }
+
+    if (!dispatchDegree(bv.order - 1, [&](auto Q) {
+            tensorSecondPass<decltype(Q)::value + 1>(net, rational, bu, bv, intermediate, surfacePoints);
+        })) {
+        tensorSecondPass<0>(net, rational, bu, bv, intermediate, surfacePoints);
+    }
+}
+
+} // namespace
+
+// ========================
+// Bezier 曲面：矩阵形式 S = B_u · P · B_v^T
+// ========================
+namespace {
+
+// 次数或采样数与缓存不同时重新计算伯恩斯坦矩阵
+void updateBernsteinMatrix(BernsteinMatrix& result, int degree, int numSamples) {
+    if (result.degree == degree && result.numSamples == numSamples) return;
+    result.degree = degree;
+    result.numSamples = numSamples;
+
+    int rows = numSamples + 1;
+    int cols = degree + 1;
+    result.matrix.resize(static_cast<size_t>(rows) * cols);
+    result.transposed.resize(result.matrix.size());
+    std::vector<double> B(cols);
+    for (int s = 0; s < rows; ++s) {
+        double t = numSamples > 0 ? static_cast<double>(s) / numSamples : 0.0;
+        // 三角递推 B_i^k = (1-t) B_i^{k-1} + t B_{i-1}^{k-1}：无 pow、无二项式系数溢出
+        std::fill(B.begin(), B.end(), 0.0);
+        B[0] = 1.0;
+        for (int k = 1; k <= degree; ++k) {
+            for (int i = k; i > 0; --i) {
+                B[i] = (1.0 - t) * B[i] + t * B[i - 1];
+            }
+            B[0] *= (1.0 - t);
+        }
+        for (int i = 0; i < cols; ++i) {
+            // 高次时两端的基函数值远小于 float 精度，置零以免矩阵乘中产生非规格化数拖慢运算
+            float value = B[i] < 1e-30 ? 0.0f : static_cast<float>(B[i]);
+            result.matrix[static_cast<size_t>(s) * cols + i] = value;
+            result.transposed[static_cast<size_t>(i) * rows + s] = value;
+        }
+    }
+}
+
+// 分块矩阵乘法 C = A · B（行优先，A: M×K，B: K×N）。
+// i-k-j 顺序使最内层沿 C、B 的行连续访问；__restrict 让编译器无需别名检查即可向量化。
+void multiplyBlocked(const float* A, const float* B, float* C, int M, int K, int N) {
+    constexpr int kBlock = 64;
+    std::fill(C, C + static_cast<size_t>(M) * N, 0.0f);
+    for (int i0 = 0; i0 < M; i0 += kBlock) {
+        int i1 = std::min(i0 + kBlock, M);
+        for (int k0 = 0; k0 < K; k0 += kBlock) {
+            int k1 = std::min(k0 + kBlock, K);
+            for (int j0 = 0; j0 < N; j0 += kBlock) {
+                int j1 = std::min(j0 + kBlock, N);
+                for (int i = i0; i < i1; ++i) {
+                    float* __restrict c = C + static_cast<size_t>(i) * N;
+                    for (int k = k0; k < k1; ++k) {
+                        float a = A[static_cast<size_t>(i) * K + k];
+                        const float* __restrict b = B + static_cast<size_t>(k) * N;
+                        for (int j = j0; j < j1; ++j) {
+                            c[j] += a * b[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
 // ========================
 // 5. Bezier Surface
 // ========================
-std::vector<glm::vec3> evaluateBezierSurface(const std::vector<std::vector<glm::vec3>>& controlPoints, 
-                                           int uSamples, int vSamples) {
-    std::vector<glm::vec3> surfacePoints;
-    if (controlPoints.empty() || controlPoints[0].empty()) return surfacePoints;
-    
+size_t evaluateBezierSurface(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                             int uSamples, int vSamples, BezierSurfaceCache& cache,
+                             glm::vec3* out, size_t capacity) {
+    if (controlPoints.empty() || controlPoints[0].empty()) return 0;
     int n = static_cast<int>(controlPoints.size()) - 1;      // u方向控制点数-1
     int m = static_cast<int>(controlPoints[0].size()) - 1;   // v方向控制点数-1
-    
-    if (n < 0 || m < 0) return surfacePoints;
-    
-    // 双线性插值计算贝塞尔曲面点
-    for (int i = 0; i <= uSamples; ++i) {
-        float u = static_cast<float>(i) / uSamples;
-        for (int j = 0; j <= vSamples; ++j) {
-            float v = static_cast<float>(j) / vSamples;
-            
-            glm::vec3 point(0.0f);
-            for (int k = 0; k <= n; ++k) {
-                float bernsteinU = bernsteinPolynomial(n, k, u);
-                for (int l = 0; l <= m; ++l) {
-                    float bernsteinV = bernsteinPolynomial(m, l, v);
-                    point += bernsteinU * bernsteinV * controlPoints[k][l];
-                }
+    size_t count = surfaceOutputSize(n + 1, m + 1, uSamples, vSamples);
+    if (count == 0 || capacity < count) return 0;
+    int U = uSamples + 1;
+    int V = vSamples + 1;
+
+    updateBernsteinMatrix(cache.u, n, uSamples);
+    updateBernsteinMatrix(cache.v, m, vSamples);
+    const BernsteinMatrix& Bu = cache.u;
+    const BernsteinMatrix& Bv = cache.v;
+
+    // 每个坐标分量做两次小矩阵乘：T = B_u · P_c，S_c = T · B_v^T（工作区线程局部复用）
+    thread_local std::vector<float> P, T, S;
+    P.resize(static_cast<size_t>(n + 1) * (m + 1));
+    T.resize(static_cast<size_t>(U) * (m + 1));
+    S.resize(count);
+    for (int c = 0; c < 3; ++c) {
+        for (int k = 0; k <= n; ++k) {
+            for (int l = 0; l <= m; ++l) {
+                P[static_cast<size_t>(k) * (m + 1) + l] = controlPoints[k][l][c];
             }
-            surfacePoints.push_back(point);
         }
+        multiplyBlocked(Bu.matrix.data(), P.data(), T.data(), U, n + 1, m + 1);
+        multiplyBlocked(T.data(), Bv.transposed.data(), S.data(), U, m + 1, V);
+        for (size_t k = 0; k < count; ++k) out[k][c] = S[k];
     }
-    
+    return count;
+}
+
+size_t evaluateBezierSurface(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                             int uSamples, int vSamples,
+                             glm::vec3* out, size_t capacity) {
+    BezierSurfaceCache local;
+    return evaluateBezierSurface(controlPoints, uSamples, vSamples, local, out, capacity);
+}
+
+std::vector<glm::vec3> evaluateBezierSurface(const std::vector<std::vector<glm::vec3>>& controlPoints, 
+                                           int uSamples, int vSamples) {
+    std::vector<glm::vec3> surfacePoints(controlPoints.empty() ? 0 :
+        surfaceOutputSize(static_cast<int>(controlPoints.size()), static_cast<int>(controlPoints[0].size()),
+                          uSamples, vSamples));
+    evaluateBezierSurface(controlPoints, uSamples, vSamples, surfacePoints.data(), surfacePoints.size());
     return surfacePoints;
 }
 
-// 辅助函数：伯恩斯坦基函数
 float bernsteinPolynomial(int n, int i, float t) {
-    return binomialCoefficient(n, i) * pow(t, i) * pow(1.0f - t, n - i);
+    if (i < 0 || i > n) return 0.0f;
+    // 二项式系数按 double 递推，高次时不会像 int 那样溢出
+    int k = std::min(i, n - i);
+    double coeff = 1.0;
+    for (int j = 0; j < k; ++j) {
+        coeff = coeff * (n - j) / (j + 1);
+    }
+    return static_cast<float>(coeff * std::pow(static_cast<double>(t), i) * std::pow(1.0 - t, n - i));
+}
+
+void bernsteinBasis(int degree, float t, float* B) {
+    B[0] = 1.0f;
+    for (int k = 1; k <= degree; ++k) {
+        B[k] = t * B[k - 1];
+        for (int i = k - 1; i > 0; --i) {
+            B[i] = (1.0f - t) * B[i] + t * B[i - 1];
+        }
+        B[0] *= (1.0f - t);
+    }
 }
 
 // 辅助函数：二项式系数
 int binomialCoefficient(int n, int k) {
     if (k > n || k < 0) return 0;
     if (k == 0 || k == n) return 1;
+    k = std::min(k, n - k);
     
-    int result = 1;
+    // 64 位中间结果；超出 int 范围时饱和到 INT_MAX
+    long long result = 1;
     for (int i = 0; i < k; ++i) {
         result = result * (n - i) / (i + 1);
+        if (result > std::numeric_limits<int>::max()) return std::numeric_limits<int>::max();
     }
-    return result;
+    return static_cast<int>(result);
 }
 
 // ========================
 // 6. B-Spline Surface
 // ========================
-std::vector<glm::vec3> evaluateBSplineSurface(const std::vector<std::vector<glm::vec3>>& controlPoints,
-                                             int degreeU, int degreeV,
-                                             int uSamples, int vSamples) {
-    std::vector<glm::vec3> surfacePoints;
-    if (controlPoints.empty() || controlPoints[0].empty()) return surfacePoints;
-    
-    int n = static_cast<int>(controlPoints.size()) - 1;      // u方向控制点数-1
-    int m = static_cast<int>(controlPoints[0].size()) - 1;   // v方向控制点数-1
-    
-    if (n < 0 || m < 0) return surfacePoints;
-    
-    // 限制次数不超过控制点数-1
-    if (degreeU > n) degreeU = n;
-    if (degreeV > m) degreeV = m;
+size_t surfaceOutputSize(int rows, int cols, int uSamples, int vSamples) {
+    if (rows <= 0 || cols <= 0 || uSamples < 0 || vSamples < 0) return 0;
+    return static_cast<size_t>(uSamples + 1) * (vSamples + 1);
+}
+
+size_t evaluateBSplineSurface(const ControlNet& net,
+                              int degreeU, int degreeV,
+                              int uSamples, int vSamples,
+                              glm::vec3* out, size_t capacity) {
+    size_t count = surfaceOutputSize(net.rows, net.cols, uSamples, vSamples);
+    if (count == 0 || capacity < count) return 0;
+
+    // 限制次数不超过控制点数-1（buildBasisTable 内部截断）
     if (degreeU < 1) degreeU = 1;
     if (degreeV < 1) degreeV = 1;
-    
-    // 生成节点向量
-    auto knotsU = generateClampedKnotVector(n + 1, degreeU);
-    auto knotsV = generateClampedKnotVector(m + 1, degreeV);
-    
-    // 计算曲面点
-    for (int i = 0; i <= uSamples; ++i) {
-        float u = static_cast<float>(i) / uSamples;
-        for (int j = 0; j <= vSamples; ++j) {
-            float v = static_cast<float>(j) / vSamples;
-            
-            glm::vec3 point(0.0f);
-            for (int k = 0; k <= n; ++k) {
-                float basisU = coxDeBoor(k, degreeU, u, knotsU);
-                for (int l = 0; l <= m; ++l) {
-                    float basisV = coxDeBoor(l, degreeV, v, knotsV);
-                    point += basisU * basisV * controlPoints[k][l];
-                }
-            }
-            surfacePoints.push_back(point);
-        }
-    }
-    
+
+    BasisTable bu = buildBasisTable(net.rows, degreeU, uSamples);
+    BasisTable bv = buildBasisTable(net.cols, degreeV, vSamples);
+    evaluateTensorSurface(net, false, bu, bv, out);
+    return count;
+}
+
+std::vector<glm::vec3> evaluateBSplineSurface(const ControlNet& net,
+                                             int degreeU, int degreeV,
+                                             int uSamples, int vSamples) {
+    std::vector<glm::vec3> surfacePoints(surfaceOutputSize(net.rows, net.cols, uSamples, vSamples));
+    evaluateBSplineSurface(net, degreeU, degreeV, uSamples, vSamples, surfacePoints.data(), surfacePoints.size());
     return surfacePoints;
 }
 
+std::vector<glm::vec3> evaluateBSplineSurface(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                                             int degreeU, int degreeV,
+                                             int uSamples, int vSamples) {
+    if (controlPoints.empty() || controlPoints[0].empty()) return {};
+    return evaluateBSplineSurface(makeControlNet(controlPoints), degreeU, degreeV, uSamples, vSamples);
+}
+
 // ========================
 // 7. NURBS Surface
 // ========================
+size_t evaluateNURBSSurface(const ControlNet& net,
+                            int degreeU, int degreeV,
+                            int uSamples, int vSamples,
+                            glm::vec3* out, size_t capacity) {
+    size_t count = surfaceOutputSize(net.rows, net.cols, uSamples, vSamples);
+    if (count == 0 || capacity < count) return 0;
+
+    if (degreeU < 1) degreeU = 1;
+    if (degreeV < 1) degreeV = 1;
+
+    BasisTable bu = buildBasisTable(net.rows, degreeU, uSamples);
+    BasisTable bv = buildBasisTable(net.cols, degreeV, vSamples);
+    evaluateTensorSurface(net, true, bu, bv, out);
+    return count;
+}
+
+std::vector<glm::vec3> evaluateNURBSSurface(const ControlNet& net,
+                                           int degreeU, int degreeV,
+                                           int uSamples, int vSamples) {
+    std::vector<glm::vec3> surfacePoints(surfaceOutputSize(net.rows, net.cols, uSamples, vSamples));
+    evaluateNURBSSurface(net, degreeU, degreeV, uSamples, vSamples, surfacePoints.data(), surfacePoints.size());
+    return surfacePoints;
+}
+
 std::vector<glm::vec3> evaluateNURBSSurface(const std::vector<std::vector<glm::vec3>>& controlPoints,
                                            const std::vector<std::vector<float>>& weights,
                                            int degreeU, int degreeV,
                                            int uSamples, int vSamples) {
-    std::vector<glm::vec3> surfacePoints;
-    if (controlPoints.empty() || controlPoints[0].empty()) return surfacePoints;
+    if (controlPoints.empty() || controlPoints[0].empty()) return {};
     if (controlPoints.size() != weights.size() || 
         (controlPoints.size() > 0 && controlPoints[0].size() != weights[0].size())) {
-        return surfacePoints; // 权重和控制点维度必须一致
+        return {}; // 权重和控制点维度必须一致
     }
-    
-    int n = static_cast<int>(controlPoints.size()) - 1;      // u方向控制点数-1
-    int m = static_cast<int>(controlPoints[0].size()) - 1;   // v方向控制点数-1
-    
-    if (n < 0 || m < 0) return surfacePoints;
-    
-    // 限制次数不超过控制点数-1
-    if (degreeU > n) degreeU = n;
-    if (degreeV > m) degreeV = m;
-    if (degreeU < 1) degreeU = 1;
-    if (degreeV < 1) degreeV = 1;
-    
-    // 生成节点向量
-    auto knotsU = generateClampedKnotVector(n + 1, degreeU);
-    auto knotsV = generateClampedKnotVector(m + 1, degreeV);
-    
-    // 计算曲面点
-    for (int i = 0; i <= uSamples; ++i) {
-        float u = static_cast<float>(i) / uSamples;
-        for (int j = 0; j <= vSamples; ++j) {
-            float v = static_cast<float>(j) / vSamples;
-            
-            float denominator = 0.0f;
-            glm::vec3 numerator(0.0f);
-            
-            for (int k = 0; k <= n; ++k) {
-                float basisU = coxDeBoor(k, degreeU, u, knotsU);
-                for (int l = 0; l <= m; ++l) {
-                    float basisV = coxDeBoor(l, degreeV, v, knotsV);
-                    float w = weights[k][l];
-                    float weight = w * basisU * basisV;
-                    numerator += weight * controlPoints[k][l];
-                    denominator += weight;
-                }
-            }
-            
-            if (std::abs(denominator) > 1e-6f) {
-                surfacePoints.push_back(numerator / denominator);
-            } else {
-                // 退化情况，使用普通B样条
-                glm::vec3 point(0.0f);
-                for (int k = 0; k <= n; ++k) {
-                    float basisU = coxDeBoor(k, degreeU, u, knotsU);
-                    for (int l = 0; l <= m; ++l) {
-                        float basisV = coxDeBoor(l, degreeV, v, knotsV);
-                        point += basisU * basisV * controlPoints[k][l];
-                    }
-                }
-                surfacePoints.push_back(point);
-            }
-        }
-    }
-    
-    return surfacePoints;
+    return evaluateNURBSSurface(makeControlNet(controlPoints, weights), degreeU, degreeV, uSamples, vSamples);
 }
 
 // ========================
 // 8. 生成曲面索引（用于渲染）
 // ========================
-std::vector<unsigned int> generateSurfaceIndices(int uSamples, int vSamples) {
-    std::vector<unsigned int> indices;
-    
+size_t surfaceIndexCount(int uSamples, int vSamples) {
+    if (uSamples <= 0 || vSamples <= 0) return 0;
+    return static_cast<size_t>(uSamples) * vSamples * 6;
+}
+
+size_t generateSurfaceIndices(int uSamples, int vSamples, unsigned int* out, size_t capacity) {
+    size_t count = surfaceIndexCount(uSamples, vSamples);
+    if (capacity < count) return 0;
+
+    size_t k = 0;
     for (int i = 0; i < uSamples; ++i) {
         for (int j = 0; j < vSamples; ++j) {
             unsigned int topLeft = i * (vSamples + 1) + j;
@@ -335,17 +845,22 @@ std::vector<unsigned int> generateSurfaceIndices(int uSamples, int vSamples) {
             unsigned int bottomRight = bottomLeft + 1;
             
             // 第一个三角形
-            indices.push_back(topLeft);
-            indices.push_back(bottomLeft);
-            indices.push_back(topRight);
+            out[k++] = topLeft;
+            out[k++] = bottomLeft;
+            out[k++] = topRight;
             
             // 第二个三角形
-            indices.push_back(topRight);
-            indices.push_back(bottomLeft);
-            indices.push_back(bottomRight);
+            out[k++] = topRight;
+            out[k++] = bottomLeft;
+            out[k++] = bottomRight;
         }
     }
-    
+    return count;
+}
+
+std::vector<unsigned int> generateSurfaceIndices(int uSamples, int vSamples) {
+    std::vector<unsigned int> indices(surfaceIndexCount(uSamples, vSamples));
+    generateSurfaceIndices(uSamples, vSamples, indices.data(), indices.size());
     return indices;
 }
 
@@ -2,10 +2,34 @@
 
 #include <vector>
 #include <glm/glm.hpp>
+#include "control_net.h"
 
 namespace Spline {
 
-// Bezier 曲线：de Casteljau 算法
+struct PowerBasisCache;
+
+// 一维采样基函数表：参数 s / numSamples（s = 0..numSamples）处的 order 个非零基函数
+// 对应控制点 first[s] .. first[s] + order - 1
+struct BasisTable {
+    int order = 0;             // degree + 1
+    std::vector<int> first;    // 每个采样点第一个非零基函数的控制点下标
+    std::vector<float> values; // first.size() * order
+};
+
+// 参数 s / numSamples（s = 0..numSamples）处的 degree 次伯恩斯坦基函数
+struct BernsteinMatrix {
+    int degree = -1, numSamples = -1;
+    std::vector<float> matrix;     // (numSamples + 1) × (degree + 1)，行优先
+    std::vector<float> transposed; // (degree + 1) × (numSamples + 1)
+};
+
+// Bezier 曲面两个方向的伯恩斯坦矩阵，次数或采样数变化时重新计算
+struct BezierSurfaceCache {
+    BernsteinMatrix u, v;
+};
+
+// Bezier 曲线：次数不超过 512 时在 numSamples + 1 个均匀参数上做 O(n) Horner 求值（double 精度）；
+// 更高次数改用 de Casteljau 自适应细分，输出点数不固定（见 bezierOutputSize）
 std::vector<glm::vec3> evaluateBezier(const std::vector<glm::vec3>& controlPoints, int numSamples = 100);
 
 // B 样条曲线
@@ -31,11 +55,82 @@ std::vector<glm::vec3> evaluateNURBSSurface(const std::vector<std::vector<glm::v
                                            int degreeU, int degreeV,
                                            int uSamples, int vSamples);
 
+// 直接读取连续控制网格的版本（上面两个二维数组接口内部先转换为 ControlNet）。
+// B 样条版本只使用笛卡尔坐标，忽略网格中的权重
+std::vector<glm::vec3> evaluateBSplineSurface(const ControlNet& net,
+                                             int degreeU, int degreeV,
+                                             int uSamples, int vSamples);
+
+std::vector<glm::vec3> evaluateNURBSSurface(const ControlNet& net,
+                                           int degreeU, int degreeV,
+                                           int uSamples, int vSamples);
+
+// ========================
+// 写入调用方缓冲区的求值接口
+// ========================
+// *OutputSize / surfaceIndexCount 预先给出所需的输出容量；求值函数把结果写入 out[0..capacity)，
+// 返回实际写入的元素个数，容量不足时不写入并返回 0。调用方复用同一块缓冲区即可避免逐帧分配，
+// 上面返回 std::vector 的版本都是它们的包装。
+
+// Bezier 曲线：Horner 路径恰为 numSamples + 1；极高次的自适应细分路径为上界，实际写入可能更少
+size_t bezierOutputSize(int numControlPoints, int numSamples);
+// B 样条 / NURBS 曲线（两者相同）
+size_t bsplineOutputSize(int numControlPoints, int degree, int numSamples);
+// 张量积曲面（Bezier / B 样条 / NURBS 相同）：(uSamples + 1) × (vSamples + 1)
+size_t surfaceOutputSize(int rows, int cols, int uSamples, int vSamples);
+size_t surfaceIndexCount(int uSamples, int vSamples);
+
+size_t evaluateBezier(const std::vector<glm::vec3>& controlPoints, int numSamples,
+                      glm::vec3* out, size_t capacity);
+size_t evaluateBSpline(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples,
+                       glm::vec3* out, size_t capacity);
+size_t evaluateNURBS(const std::vector<glm::vec3>& controlPoints,
+                     const std::vector<float>& weights,
+                     int degree, int numSamples,
+                     glm::vec3* out, size_t capacity);
+// 密集采样（见 shouldUsePowerBasis）时走幂基 Horner 路径。上面两个版本每次调用都重新转换幂基形式；
+// 带 PowerBasisCache 的版本按调用方的修改计数复用转换结果，逐帧求值同一条曲线时应使用它们
+size_t evaluateBSpline(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples,
+                       PowerBasisCache& cache, uint64_t pointsGeneration,
+                       glm::vec3* out, size_t capacity);
+size_t evaluateNURBS(const std::vector<glm::vec3>& controlPoints,
+                     const std::vector<float>& weights,
+                     int degree, int numSamples,
+                     PowerBasisCache& cache, uint64_t pointsGeneration, uint64_t weightsGeneration,
+                     glm::vec3* out, size_t capacity);
+size_t evaluateBezierSurface(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                             int uSamples, int vSamples,
+                             glm::vec3* out, size_t capacity);
+// 上面的版本每次调用都重新计算伯恩斯坦矩阵；逐帧求值同样尺寸与采样数的曲面时传入调用方持有的缓存
+size_t evaluateBezierSurface(const std::vector<std::vector<glm::vec3>>& controlPoints,
+                             int uSamples, int vSamples, BezierSurfaceCache& cache,
+                             glm::vec3* out, size_t capacity);
+size_t evaluateBSplineSurface(const ControlNet& net,
+                              int degreeU, int degreeV,
+                              int uSamples, int vSamples,
+                              glm::vec3* out, size_t capacity);
+size_t evaluateNURBSSurface(const ControlNet& net,
+                            int degreeU, int degreeV,
+                            int uSamples, int vSamples,
+                            glm::vec3* out, size_t capacity);
+size_t generateSurfaceIndices(int uSamples, int vSamples, unsigned int* out, size_t capacity);
+
+// 在 numSamples + 1 个均匀参数上预计算钳位 B 样条基函数
+// degree 按求值函数的规则截断到 [1, numControlPoints - 1]；只有一个控制点时退化为常数
+BasisTable buildBasisTable(int numControlPoints, int degree, int numSamples);
+
 // 辅助函数
 std::vector<unsigned int> generateSurfaceIndices(int uSamples, int vSamples);
 
 // 内部辅助函数声明
+std::vector<float> generateClampedKnotVector(int numControlPoints, int degree);
+int findKnotSpan(int numControlPoints, int degree, float u, const std::vector<float>& knots);
+int findKnotSpan(int numControlPoints, int degree, float u, const float* knots);
+void basisFunctions(int span, float u, int degree, const std::vector<float>& knots, float* N);
+void basisFunctions(int span, float u, int degree, const float* knots, float* N);
 float bernsteinPolynomial(int n, int i, float t);
+// 三角递推计算全部 degree + 1 个伯恩斯坦基函数值，写入 B[0..degree]
+void bernsteinBasis(int degree, float t, float* B);
 int binomialCoefficient(int n, int k);
 
 } // namespace Spline
\ No newline at end of file
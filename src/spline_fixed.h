@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+#include <glm/glm.hpp>
+
+namespace Spline {
+
+// 编译期固定次数的求值内核（1..kMaxFixedDegree 次），基函数存放在定长栈数组中，
+// 递推循环边界为常量，可被编译器完全展开。更高次数由调用方回退到运行时次数的通用实现。
+constexpr int kMaxFixedDegree = 5;
+
+// 把运行时 degree 分派到 f(std::integral_constant<int, P>{})；返回 false 表示超出特化范围
+template <typename F>
+bool dispatchDegree(int degree, F&& f) {
+    switch (degree) {
+    case 1: f(std::integral_constant<int, 1>{}); return true;
+    case 2: f(std::integral_constant<int, 2>{}); return true;
+    case 3: f(std::integral_constant<int, 3>{}); return true;
+    case 4: f(std::integral_constant<int, 4>{}); return true;
+    case 5: f(std::integral_constant<int, 5>{}); return true;
+    default: return false;
+    }
+}
+
+// 与 basisFunctions 相同的三角递推，P 为编译期常量
+template <int P>
+inline void basisFunctionsFixed(int span, float u, const float* knots, float (&N)[P + 1]) {
+    N[0] = 1.0f;
+    for (int j = 1; j <= P; ++j) {
+        float saved = 0.0f;
+        for (int r = 0; r < j; ++r) {
+            float right = knots[span + r + 1] - u;
+            float left = u - knots[span + 1 + r - j];
+            float temp = N[r] / (right + left);
+            N[r] = saved + right * temp;
+            saved = left * temp;
+        }
+        N[j] = saved;
+    }
+}
+
+// 定长加权求和 sum_{a < ORDER} c[a] * q[a]：曲线内核的控制点组合与张量积曲面第二遍的内层
+template <int ORDER, typename T>
+inline T weightedSumFixed(const float* c, const T* q) {
+    T h(0.0f);
+    for (int a = 0; a < ORDER; ++a) h += c[a] * q[a];
+    return h;
+}
+
+// 曲线在 u = s / numSamples (s = 0..numSamples-1) 上的采样，写入 out[0..numSamples)。
+// weights 为空指针时为多项式曲线；分母退化时回退为非有理组合（与 evaluateNURBS 一致）。
+template <int P>
+void evaluateCurveFixed(const glm::vec3* controlPoints, const float* weights, int numControlPoints,
+                        const float* knots, int numSamples, glm::vec3* out) {
+    const int n = numControlPoints - 1;
+    int span = P;
+    float N[P + 1];
+    for (int s = 0; s < numSamples; ++s) {
+        float u = static_cast<float>(s) / numSamples;
+        // 采样单调递增：节点区间顺序推进，等价于 findKnotSpan
+        while (span < n && u >= knots[span + 1]) ++span;
+        basisFunctionsFixed<P>(span, u, knots, N);
+        const glm::vec3* pts = controlPoints + (span - P);
+
+        if (!weights) {
+            out[s] = weightedSumFixed<P + 1>(N, pts);
+            continue;
+        }
+
+        const float* w = weights + (span - P);
+        float denominator = 0.0f;
+        glm::vec3 numerator(0.0f);
+        for (int a = 0; a <= P; ++a) {
+            numerator += w[a] * N[a] * pts[a];
+            denominator += w[a] * N[a];
+        }
+        if (std::abs(denominator) > 1e-6f) {
+            out[s] = numerator / denominator;
+        } else {
+            out[s] = weightedSumFixed<P + 1>(N, pts);
+        }
+    }
+}
+
+// 一维基函数表的填充（buildBasisTable 的内核），values 为 (numSamples + 1) × (P + 1)
+template <int P>
+void fillBasisTableFixed(int numControlPoints, const float* knots, int numSamples, int* first, float* values) {
+    const int n = numControlPoints - 1;
+    int span = P;
+    for (int s = 0; s <= numSamples; ++s) {
+        float u = numSamples > 0 ? static_cast<float>(s) / numSamples : 0.0f;
+        while (span < n && u >= knots[span + 1]) ++span;
+        float N[P + 1];
+        basisFunctionsFixed<P>(span, u, knots, N);
+        for (int a = 0; a <= P; ++a) values[s * (P + 1) + a] = N[a];
+        first[s] = span - P;
+    }
+}
+
+} // namespace Spline
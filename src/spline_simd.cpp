@@ -0,0 +1,359 @@
+#include "spline_simd.h"
+#include "spline.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPLINE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Spline {
+
+namespace {
+
+// 批量核使用栈上定长数组，更高次数走标量路径
+constexpr int kMaxBatchDegree = 15;
+
+SimdLevel& currentSimdLevel() {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+// 单个参数的标量求值，同时作为尾部和退化分母的回退路径
+glm::vec3 evaluateCurveSample(const ControlPointsSoA& cp, int degree, const std::vector<float>& knots,
+                              bool rational, float u, float* N) {
+    int span = findKnotSpan(static_cast<int>(cp.size()), degree, u, knots);
+    basisFunctions(span, u, degree, knots, N);
+    int first = span - degree;
+
+    glm::vec4 h(0.0f);
+    for (int a = 0; a <= degree; ++a) {
+        int i = first + a;
+        h += N[a] * glm::vec4(cp.x[i], cp.y[i], cp.z[i], cp.w[i]);
+    }
+    if (!rational) return glm::vec3(h);
+    if (std::abs(h.w) > 1e-6f) return glm::vec3(h) / h.w;
+
+    // 退化情况，使用普通B样条
+    glm::vec3 pt(0.0f);
+    for (int a = 0; a <= degree; ++a) {
+        int i = first + a;
+        if (cp.w[i] != 0.0f) pt += N[a] * glm::vec3(cp.x[i], cp.y[i], cp.z[i]) / cp.w[i];
+    }
+    return pt;
+}
+
+// 批量参数通常单调递增：先检查上一个区间，命中失败再二分查找
+inline int findKnotSpanHint(int n, int degree, float u, const std::vector<float>& knots, int hint) {
+    if (hint >= degree && hint < n && u >= knots[hint] && u < knots[hint + 1]) return hint;
+    return findKnotSpan(n, degree, u, knots);
+}
+
+void curveKernelScalar(const ControlPointsSoA& cp, int degree, const std::vector<float>& knots,
+                       bool rational, const float* params, int count, glm::vec3* out) {
+    std::vector<float> N(degree + 1);
+    for (int k = 0; k < count; ++k) {
+        out[k] = evaluateCurveSample(cp, degree, knots, rational, params[k], N.data());
+    }
+}
+
+#ifdef SPLINE_SIMD_X86
+
+// ========================
+// SSE2：每批 4 个参数
+// ========================
+__attribute__((target("sse2")))
+void curveKernelSSE(const ControlPointsSoA& cp, int degree, const std::vector<float>& knots,
+                    bool rational, const float* params, int count, glm::vec3* out) {
+    const int p = degree;
+    const int n = static_cast<int>(cp.size());
+    const float* K = knots.data();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 eps = _mm_set1_ps(1e-6f);
+    float scratch[kMaxBatchDegree + 1];
+    int hint = -1;
+
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        int span[4];
+        for (int l = 0; l < 4; ++l) {
+            span[l] = findKnotSpanHint(n, p, params[k + l], knots, l > 0 ? span[l - 1] : hint);
+        }
+        hint = span[3];
+        __m128 u = _mm_loadu_ps(params + k);
+
+        // 各通道的节点窗口 knots[span - p + 1 .. span + p]，转置为 SoA
+        __m128 T[2 * kMaxBatchDegree];
+        for (int t = 0; t < 2 * p; ++t) {
+            int o = t - p + 1;
+            T[t] = _mm_setr_ps(K[span[0] + o], K[span[1] + o], K[span[2] + o], K[span[3] + o]);
+        }
+
+        // 三角递推，与 basisFunctions 相同
+        __m128 N[kMaxBatchDegree + 1];
+        N[0] = _mm_set1_ps(1.0f);
+        for (int j = 1; j <= p; ++j) {
+            __m128 saved = zero;
+            for (int r = 0; r < j; ++r) {
+                __m128 right = _mm_sub_ps(T[p + r], u);
+                __m128 left = _mm_sub_ps(u, T[p + r - j]);
+                __m128 temp = _mm_div_ps(N[r], _mm_add_ps(right, left));
+                N[r] = _mm_add_ps(saved, _mm_mul_ps(right, temp));
+                saved = _mm_mul_ps(left, temp);
+            }
+            N[j] = saved;
+        }
+
+        // 加权求和：密集采样时同批参数通常落在同一区间，直接广播控制点
+        bool sameSpan = span[0] == span[1] && span[0] == span[2] && span[0] == span[3];
+        __m128 ax = zero, ay = zero, az = zero, aw = zero;
+        for (int a = 0; a <= p; ++a) {
+            __m128 cx, cy, cz, cw;
+            if (sameSpan) {
+                int i = span[0] - p + a;
+                cx = _mm_set1_ps(cp.x[i]);
+                cy = _mm_set1_ps(cp.y[i]);
+                cz = _mm_set1_ps(cp.z[i]);
+                cw = _mm_set1_ps(cp.w[i]);
+            } else {
+                int i0 = span[0] - p + a, i1 = span[1] - p + a;
+                int i2 = span[2] - p + a, i3 = span[3] - p + a;
+                cx = _mm_setr_ps(cp.x[i0], cp.x[i1], cp.x[i2], cp.x[i3]);
+                cy = _mm_setr_ps(cp.y[i0], cp.y[i1], cp.y[i2], cp.y[i3]);
+                cz = _mm_setr_ps(cp.z[i0], cp.z[i1], cp.z[i2], cp.z[i3]);
+                cw = _mm_setr_ps(cp.w[i0], cp.w[i1], cp.w[i2], cp.w[i3]);
+            }
+            ax = _mm_add_ps(ax, _mm_mul_ps(N[a], cx));
+            ay = _mm_add_ps(ay, _mm_mul_ps(N[a], cy));
+            az = _mm_add_ps(az, _mm_mul_ps(N[a], cz));
+            aw = _mm_add_ps(aw, _mm_mul_ps(N[a], cw));
+        }
+
+        int degenerate = 0;
+        if (rational) {
+            degenerate = _mm_movemask_ps(_mm_cmple_ps(_mm_andnot_ps(signMask, aw), eps));
+            __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), aw);
+            ax = _mm_mul_ps(ax, inv);
+            ay = _mm_mul_ps(ay, inv);
+            az = _mm_mul_ps(az, inv);
+        }
+
+        alignas(16) float xs[4], ys[4], zs[4];
+        _mm_store_ps(xs, ax);
+        _mm_store_ps(ys, ay);
+        _mm_store_ps(zs, az);
+        for (int l = 0; l < 4; ++l) {
+            out[k + l] = (degenerate & (1 << l))
+                ? evaluateCurveSample(cp, degree, knots, rational, params[k + l], scratch)
+                : glm::vec3(xs[l], ys[l], zs[l]);
+        }
+    }
+    curveKernelScalar(cp, degree, knots, rational, params + k, count - k, out + k);
+}
+
+// ========================
+// AVX2 + FMA：每批 8 个参数，节点窗口与离散控制点用 gather 读取
+// ========================
+__attribute__((target("avx2,fma")))
+void curveKernelAVX2(const ControlPointsSoA& cp, int degree, const std::vector<float>& knots,
+                     bool rational, const float* params, int count, glm::vec3* out) {
+    const int p = degree;
+    const int n = static_cast<int>(cp.size());
+    const float* K = knots.data();
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 eps = _mm256_set1_ps(1e-6f);
+    float scratch[kMaxBatchDegree + 1];
+    int hint = -1;
+
+    int k = 0;
+    for (; k + 8 <= count; k += 8) {
+        alignas(32) int span[8];
+        for (int l = 0; l < 8; ++l) {
+            span[l] = findKnotSpanHint(n, p, params[k + l], knots, l > 0 ? span[l - 1] : hint);
+        }
+        hint = span[7];
+        __m256i spanVec = _mm256_load_si256(reinterpret_cast<const __m256i*>(span));
+        __m256 u = _mm256_loadu_ps(params + k);
+
+        __m256 T[2 * kMaxBatchDegree];
+        for (int t = 0; t < 2 * p; ++t) {
+            __m256i idx = _mm256_add_epi32(spanVec, _mm256_set1_epi32(t - p + 1));
+            T[t] = _mm256_i32gather_ps(K, idx, 4);
+        }
+
+        __m256 N[kMaxBatchDegree + 1];
+        N[0] = _mm256_set1_ps(1.0f);
+        for (int j = 1; j <= p; ++j) {
+            __m256 saved = zero;
+            for (int r = 0; r < j; ++r) {
+                __m256 right = _mm256_sub_ps(T[p + r], u);
+                __m256 left = _mm256_sub_ps(u, T[p + r - j]);
+                __m256 temp = _mm256_div_ps(N[r], _mm256_add_ps(right, left));
+                N[r] = _mm256_fmadd_ps(right, temp, saved);
+                saved = _mm256_mul_ps(left, temp);
+            }
+            N[j] = saved;
+        }
+
+        bool sameSpan = true;
+        for (int l = 1; l < 8; ++l) sameSpan = sameSpan && span[l] == span[0];
+        __m256 ax = zero, ay = zero, az = zero, aw = zero;
+        for (int a = 0; a <= p; ++a) {
+            __m256 cx, cy, cz, cw;
+            if (sameSpan) {
+                int i = span[0] - p + a;
+                cx = _mm256_set1_ps(cp.x[i]);
+                cy = _mm256_set1_ps(cp.y[i]);
+                cz = _mm256_set1_ps(cp.z[i]);
+                cw = _mm256_set1_ps(cp.w[i]);
+            } else {
+                __m256i idx = _mm256_add_epi32(spanVec, _mm256_set1_epi32(a - p));
+                cx = _mm256_i32gather_ps(cp.x.data(), idx, 4);
+                cy = _mm256_i32gather_ps(cp.y.data(), idx, 4);
+                cz = _mm256_i32gather_ps(cp.z.data(), idx, 4);
+                cw = _mm256_i32gather_ps(cp.w.data(), idx, 4);
+            }
+            ax = _mm256_fmadd_ps(N[a], cx, ax);
+            ay = _mm256_fmadd_ps(N[a], cy, ay);
+            az = _mm256_fmadd_ps(N[a], cz, az);
+            aw = _mm256_fmadd_ps(N[a], cw, aw);
+        }
+
+        int degenerate = 0;
+        if (rational) {
+            degenerate = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_andnot_ps(signMask, aw), eps, _CMP_LE_OQ));
+            __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), aw);
+            ax = _mm256_mul_ps(ax, inv);
+            ay = _mm256_mul_ps(ay, inv);
+            az = _mm256_mul_ps(az, inv);
+        }
+
+        alignas(32) float xs[8], ys[8], zs[8];
+        _mm256_store_ps(xs, ax);
+        _mm256_store_ps(ys, ay);
+        _mm256_store_ps(zs, az);
+        for (int l = 0; l < 8; ++l) {
+            out[k + l] = (degenerate & (1 << l))
+                ? evaluateCurveSample(cp, degree, knots, rational, params[k + l], scratch)
+                : glm::vec3(xs[l], ys[l], zs[l]);
+        }
+    }
+    curveKernelSSE(cp, degree, knots, rational, params + k, count - k, out + k);
+}
+
+#endif // SPLINE_SIMD_X86
+
+} // namespace
+
+// ========================
+// 1. ISA Detection
+// ========================
+SimdLevel detectSimdLevel() {
+#ifdef SPLINE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel getSimdLevel() {
+    return currentSimdLevel();
+}
+
+void setSimdLevel(SimdLevel level) {
+    SimdLevel supported = detectSimdLevel();
+    currentSimdLevel() = static_cast<int>(level) > static_cast<int>(supported) ? supported : level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+// ========================
+// 2. Batch Curve Kernel
+// ========================
+void toSoA(const std::vector<glm::vec3>& points, const std::vector<float>& weights, ControlPointsSoA& out) {
+    assert(weights.empty() || weights.size() == points.size());
+    size_t n = points.size();
+    out.x.resize(n);
+    out.y.resize(n);
+    out.z.resize(n);
+    out.w.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        float w = weights.empty() ? 1.0f : weights[i];
+        out.x[i] = points[i].x * w;
+        out.y[i] = points[i].y * w;
+        out.z[i] = points[i].z * w;
+        out.w[i] = w;
+    }
+}
+
+void evaluateCurveBatch(const ControlPointsSoA& controlPoints, int degree, const std::vector<float>& knots,
+                        bool rational, const float* params, int count, glm::vec3* out) {
+    if (count <= 0 || controlPoints.size() == 0) return;
+    assert(degree >= 1 && degree < static_cast<int>(controlPoints.size()));
+    assert(knots.size() == controlPoints.size() + degree + 1);
+
+#ifdef SPLINE_SIMD_X86
+    if (degree <= kMaxBatchDegree) {
+        switch (getSimdLevel()) {
+            case SimdLevel::AVX2:
+                curveKernelAVX2(controlPoints, degree, knots, rational, params, count, out);
+                return;
+            case SimdLevel::SSE:
+                curveKernelSSE(controlPoints, degree, knots, rational, params, count, out);
+                return;
+            default:
+                break;
+        }
+    }
+#endif
+    curveKernelScalar(controlPoints, degree, knots, rational, params, count, out);
+}
+
+// ========================
+// 3. Batch Evaluators
+// ========================
+std::vector<glm::vec3> evaluateBSplineBatch(const std::vector<glm::vec3>& controlPoints, int degree, int numSamples) {
+    return evaluateNURBSBatch(controlPoints, {}, degree, numSamples);
+}
+
+std::vector<glm::vec3> evaluateNURBSBatch(const std::vector<glm::vec3>& controlPoints,
+                                          const std::vector<float>& weights,
+                                          int degree,
+                                          int numSamples) {
+    assert(weights.empty() || controlPoints.size() == weights.size());
+    std::vector<glm::vec3> curve;
+    size_t n = controlPoints.size();
+    if (n == 0) return curve;
+    if (degree >= static_cast<int>(n)) degree = static_cast<int>(n) - 1;
+    if (degree < 1) {
+        return controlPoints;
+    }
+
+    auto knots = generateClampedKnotVector(static_cast<int>(n), degree);
+    ControlPointsSoA soa;
+    toSoA(controlPoints, weights, soa);
+
+    // 采样 [0, 1)
+    int count = numSamples > 0 ? numSamples : 0;
+    std::vector<float> params(count);
+    for (int s = 0; s < count; ++s) params[s] = static_cast<float>(s) / numSamples;
+    curve.resize(count);
+    evaluateCurveBatch(soa, degree, knots, !weights.empty(), params.data(), count, curve.data());
+
+    // 添加终点
+    curve.push_back(controlPoints.back());
+    return curve;
+}
+
+} // namespace Spline
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Spline {
+
+// 批量求值使用的指令集，运行时检测（x86 上 SSE2 为基线，AVX2 需同时支持 FMA）
+enum class SimdLevel {
+    Scalar = 0,
+    SSE = 1,
+    AVX2 = 2
+};
+
+SimdLevel detectSimdLevel();
+SimdLevel getSimdLevel();
+// 强制使用某一级别（不会超过 detectSimdLevel()），用于对比测试
+void setSimdLevel(SimdLevel level);
+const char* simdLevelName(SimdLevel level);
+
+// SoA 齐次控制点：x/y/z 已预乘权重，即 (x·w, y·w, z·w, w)
+struct ControlPointsSoA {
+    std::vector<float> x, y, z, w;
+    size_t size() const { return w.size(); }
+};
+
+// weights 为空时按权重全为 1 处理
+void toSoA(const std::vector<glm::vec3>& points, const std::vector<float>& weights, ControlPointsSoA& out);
+
+// 在任意参数 params[0..count) 上批量求值 B 样条 / NURBS 曲线（knots 为钳位节点向量）。
+// rational = false 时忽略 w，不做除法。每批 4（SSE）或 8（AVX2）个参数并行计算基函数、
+// 加权求和与有理除法，尾部及高次（> 15）回退标量路径。
+void evaluateCurveBatch(const ControlPointsSoA& controlPoints, int degree, const std::vector<float>& knots,
+                        bool rational, const float* params, int count, glm::vec3* out);
+
+// 次数与采样数都不低于这两个值时 evaluateBSpline / evaluateNURBS 交给批量内核。
+// 常用低次（≤ 5）留在标量路径：批量内核在这些次数上只与按次数展开的标量循环持平
+constexpr int kSimdBatchMinDegree = 6;
+constexpr int kSimdBatchMinSamples = 1024;
+
+// 与 evaluateBSpline / evaluateNURBS 输出一致的批量版本（总是走批量内核，便于对比测试）。
+// 曲面没有批量版本：两遍张量积求值复用预计算的基函数表，比逐采样重算基函数的批量内核更快
+std::vector<glm::vec3> evaluateBSplineBatch(const std::vector<glm::vec3>& controlPoints, int degree = 3, int numSamples = 100);
+
+std::vector<glm::vec3> evaluateNURBSBatch(const std::vector<glm::vec3>& controlPoints,
+                                          const std::vector<float>& weights,
+                                          int degree = 3,
+                                          int numSamples = 100);
+
+} // namespace Spline
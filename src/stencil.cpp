@@ -0,0 +1,246 @@
+#include "stencil.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Spline {
+
+// ========================
+// 1. Stencil Construction
+// ========================
+void buildSurfaceStencil(EvaluationStencil& stencil, int rows, int cols,
+                         int degreeU, int degreeV, int uSamples, int vSamples) {
+    stencil.rows = rows;
+    stencil.cols = cols;
+    stencil.degreeU = degreeU;
+    stencil.degreeV = degreeV;
+    stencil.uSamples = uSamples;
+    stencil.vSamples = vSamples;
+    stencil.offsets.clear();
+    stencil.indices.clear();
+    stencil.coefficients.clear();
+
+    stencil.basisU = buildBasisTable(rows, degreeU, uSamples);
+    stencil.basisV = buildBasisTable(cols, degreeV, vSamples);
+    const BasisTable& bu = stencil.basisU;
+    const BasisTable& bv = stencil.basisV;
+    if (bu.order == 0 || bv.order == 0) return;
+
+    size_t numU = bu.first.size();
+    size_t numV = bv.first.size();
+    size_t perVertex = static_cast<size_t>(bu.order) * bv.order;
+    stencil.offsets.reserve(numU * numV + 1);
+    stencil.indices.reserve(numU * numV * perVertex);
+    stencil.coefficients.reserve(numU * numV * perVertex);
+
+    stencil.offsets.push_back(0);
+    for (size_t i = 0; i < numU; ++i) {
+        const float* Nu = &bu.values[i * bu.order];
+        for (size_t j = 0; j < numV; ++j) {
+            const float* Nv = &bv.values[j * bv.order];
+            for (int a = 0; a < bu.order; ++a) {
+                int row = bu.first[i] + a;
+                for (int b = 0; b < bv.order; ++b) {
+                    float c = Nu[a] * Nv[b];
+                    if (c == 0.0f) continue; // 端点处的零系数不必存储
+                    stencil.indices.push_back(row * cols + bv.first[j] + b);
+                    stencil.coefficients.push_back(c);
+                }
+            }
+            stencil.offsets.push_back(static_cast<int>(stencil.indices.size()));
+        }
+    }
+}
+
+void buildCurveStencil(EvaluationStencil& stencil, int numControlPoints, int degree, int numSamples) {
+    buildSurfaceStencil(stencil, numControlPoints, 1, degree, 0, numSamples, 0);
+}
+
+bool updateSurfaceStencil(EvaluationStencil& stencil, int rows, int cols,
+                          int degreeU, int degreeV, int uSamples, int vSamples) {
+    if (stencil.rows == rows && stencil.cols == cols &&
+        stencil.degreeU == degreeU && stencil.degreeV == degreeV &&
+        stencil.uSamples == uSamples && stencil.vSamples == vSamples) {
+        return false;
+    }
+    buildSurfaceStencil(stencil, rows, cols, degreeU, degreeV, uSamples, vSamples);
+    return true;
+}
+
+bool updateCurveStencil(EvaluationStencil& stencil, int numControlPoints, int degree, int numSamples) {
+    return updateSurfaceStencil(stencil, numControlPoints, 1, degree, 0, numSamples, 0);
+}
+
+// ========================
+// 2. Stencil Application
+// ========================
+size_t applyStencil(const EvaluationStencil& stencil, const std::vector<glm::vec3>& controlPoints,
+                    glm::vec3* out, size_t capacity) {
+    assert(controlPoints.size() == static_cast<size_t>(stencil.rows) * stencil.cols);
+    size_t count = stencil.vertexCount();
+    if (capacity < count) return 0;
+    for (size_t k = 0; k < count; ++k) {
+        glm::vec3 pt(0.0f);
+        for (int e = stencil.offsets[k]; e < stencil.offsets[k + 1]; ++e) {
+            pt += stencil.coefficients[e] * controlPoints[stencil.indices[e]];
+        }
+        out[k] = pt;
+    }
+    return count;
+}
+
+size_t applyStencilRational(const EvaluationStencil& stencil, const std::vector<glm::vec3>& controlPoints,
+                            const std::vector<float>& weights, glm::vec3* out, size_t capacity) {
+    assert(controlPoints.size() == static_cast<size_t>(stencil.rows) * stencil.cols);
+    assert(controlPoints.size() == weights.size());
+    size_t count = stencil.vertexCount();
+    if (capacity < count) return 0;
+    for (size_t k = 0; k < count; ++k) {
+        glm::vec4 h(0.0f);
+        glm::vec3 plain(0.0f);
+        for (int e = stencil.offsets[k]; e < stencil.offsets[k + 1]; ++e) {
+            int idx = stencil.indices[e];
+            float c = stencil.coefficients[e];
+            float cw = c * weights[idx];
+            h += glm::vec4(cw * controlPoints[idx], cw);
+            plain += c * controlPoints[idx];
+        }
+        // 退化情况（分母接近 0）回退为普通 B 样条
+        out[k] = std::abs(h.w) > 1e-6f ? glm::vec3(h) / h.w : plain;
+    }
+    return count;
+}
+
+std::vector<glm::vec3> applyStencil(const EvaluationStencil& stencil,
+                                    const std::vector<glm::vec3>& controlPoints) {
+    std::vector<glm::vec3> result(stencil.vertexCount());
+    applyStencil(stencil, controlPoints, result.data(), result.size());
+    return result;
+}
+
+std::vector<glm::vec3> applyStencilRational(const EvaluationStencil& stencil,
+                                            const std::vector<glm::vec3>& controlPoints,
+                                            const std::vector<float>& weights) {
+    std::vector<glm::vec3> result(stencil.vertexCount());
+    applyStencilRational(stencil, controlPoints, weights, result.data(), result.size());
+    return result;
+}
+
+// ========================
+// 3. Incremental Tessellation
+// ========================
+namespace {
+
+glm::vec3 projectHomogeneous(const glm::vec4& h) {
+    // 权重限制在正数范围内，分母仅在退化网格上接近 0
+    return std::abs(h.w) > 1e-6f ? glm::vec3(h) / h.w : glm::vec3(h);
+}
+
+void expandDirty(SurfaceTessellation& mesh, int uBegin, int uEnd, int vBegin, int vEnd) {
+    mesh.generation.bump();
+    if (!mesh.hasDirtyRange()) {
+        mesh.dirtyUBegin = uBegin;
+        mesh.dirtyUEnd = uEnd;
+        mesh.dirtyVBegin = vBegin;
+        mesh.dirtyVEnd = vEnd;
+        return;
+    }
+    mesh.dirtyUBegin = std::min(mesh.dirtyUBegin, uBegin);
+    mesh.dirtyUEnd = std::max(mesh.dirtyUEnd, uEnd);
+    mesh.dirtyVBegin = std::min(mesh.dirtyVBegin, vBegin);
+    mesh.dirtyVEnd = std::max(mesh.dirtyVEnd, vEnd);
+}
+
+} // namespace
+
+void basisSupportRange(const BasisTable& table, int index, int& begin, int& end) {
+    // first[] 单调不减：first[s] <= index < first[s] + order 的采样点是连续的一段
+    auto lo = std::lower_bound(table.first.begin(), table.first.end(), index - table.order + 1);
+    auto hi = std::upper_bound(lo, table.first.end(), index);
+    begin = static_cast<int>(lo - table.first.begin());
+    end = static_cast<int>(hi - table.first.begin());
+}
+
+void rebuildTessellation(SurfaceTessellation& mesh, const EvaluationStencil& stencil,
+                         const std::vector<glm::vec3>& controlPoints,
+                         const std::vector<float>& weights) {
+    assert(controlPoints.size() == static_cast<size_t>(stencil.rows) * stencil.cols);
+    assert(controlPoints.size() == weights.size());
+    size_t count = stencil.vertexCount();
+    mesh.homogeneous.assign(count, glm::vec4(0.0f));
+    mesh.positions.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        glm::vec4 h(0.0f);
+        for (int e = stencil.offsets[k]; e < stencil.offsets[k + 1]; ++e) {
+            int idx = stencil.indices[e];
+            float cw = stencil.coefficients[e] * weights[idx];
+            h += glm::vec4(cw * controlPoints[idx], cw);
+        }
+        mesh.homogeneous[k] = h;
+        mesh.positions[k] = projectHomogeneous(h);
+    }
+
+    clearTessellationDirty(mesh);
+    expandDirty(mesh, 0, static_cast<int>(stencil.basisU.first.size()),
+                0, static_cast<int>(stencil.basisV.first.size()));
+}
+
+void rebuildTessellation(SurfaceTessellation& mesh, const EvaluationStencil& stencil,
+                         const ControlNet& net, bool rational) {
+    assert(net.rows == stencil.rows && net.cols == stencil.cols);
+    assert(net.rowStride == static_cast<size_t>(net.cols));
+    size_t count = stencil.vertexCount();
+    mesh.homogeneous.assign(count, glm::vec4(0.0f));
+    mesh.positions.resize(count);
+    const glm::vec4* points = net.points.data();
+    for (size_t k = 0; k < count; ++k) {
+        glm::vec4 h(0.0f);
+        for (int e = stencil.offsets[k]; e < stencil.offsets[k + 1]; ++e) {
+            const glm::vec4& p = points[stencil.indices[e]];
+            // 多项式曲面按权重全为 1 处理
+            h += stencil.coefficients[e] * (rational ? p : glm::vec4(glm::vec3(p) / p.w, 1.0f));
+        }
+        mesh.homogeneous[k] = h;
+        mesh.positions[k] = projectHomogeneous(h);
+    }
+
+    clearTessellationDirty(mesh);
+    expandDirty(mesh, 0, static_cast<int>(stencil.basisU.first.size()),
+                0, static_cast<int>(stencil.basisV.first.size()));
+}
+
+void updateTessellationPoint(SurfaceTessellation& mesh, const EvaluationStencil& stencil,
+                             int row, int col,
+                             const glm::vec3& oldPoint, float oldWeight,
+                             const glm::vec3& newPoint, float newWeight) {
+    const BasisTable& bu = stencil.basisU;
+    const BasisTable& bv = stencil.basisV;
+    if (mesh.homogeneous.size() != stencil.vertexCount()) return;
+
+    int uBegin, uEnd, vBegin, vEnd;
+    basisSupportRange(bu, row, uBegin, uEnd);
+    basisSupportRange(bv, col, vBegin, vEnd);
+    if (uBegin >= uEnd || vBegin >= vEnd) return;
+
+    // 齐次坐标下曲面对控制点线性：只需累加 c * (w'P' - wP, w' - w)
+    glm::vec4 delta(newWeight * newPoint - oldWeight * oldPoint, newWeight - oldWeight);
+    size_t stride = bv.first.size();
+    for (int i = uBegin; i < uEnd; ++i) {
+        float cu = bu.values[static_cast<size_t>(i) * bu.order + (row - bu.first[i])];
+        if (cu == 0.0f) continue;
+        for (int j = vBegin; j < vEnd; ++j) {
+            float c = cu * bv.values[static_cast<size_t>(j) * bv.order + (col - bv.first[j])];
+            size_t k = static_cast<size_t>(i) * stride + j;
+            mesh.homogeneous[k] += c * delta;
+            mesh.positions[k] = projectHomogeneous(mesh.homogeneous[k]);
+        }
+    }
+    expandDirty(mesh, uBegin, uEnd, vBegin, vEnd);
+}
+
+void clearTessellationDirty(SurfaceTessellation& mesh) {
+    mesh.dirtyUBegin = mesh.dirtyUEnd = 0;
+    mesh.dirtyVBegin = mesh.dirtyVEnd = 0;
+}
+
+} // namespace Spline
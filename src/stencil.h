@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "spline.h"
+
+namespace Spline {
+
+// 求值模板：对固定的 (控制网格尺寸, 次数, 采样网格) 预先记录每个输出顶点
+// 受哪些控制点影响及其系数。控制点移动时只需做一次稀疏矩阵-向量乘。
+// 控制点按行优先展平：index = row * cols + col；曲线视为 cols = 1 的曲面。
+// Bezier 等价于无内部节点的钳位 B 样条，传入 degree = 控制点数 - 1 即可。
+struct EvaluationStencil {
+    // 构建参数（用于判断是否需要重建）
+    int rows = 0, cols = 0;
+    int degreeU = 0, degreeV = 0;
+    int uSamples = -1, vSamples = -1;
+
+    // 两个方向的一维基函数表，张量积即为各顶点系数
+    BasisTable basisU, basisV;
+
+    // CSR：顶点 k 的影响控制点为 indices[offsets[k] .. offsets[k + 1])
+    std::vector<int> offsets;
+    std::vector<int> indices;
+    std::vector<float> coefficients;
+
+    size_t vertexCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+// 构建曲面模板，输出 (uSamples + 1) × (vSamples + 1) 个顶点
+void buildSurfaceStencil(EvaluationStencil& stencil, int rows, int cols,
+                         int degreeU, int degreeV, int uSamples, int vSamples);
+// 构建曲线模板，输出 numSamples + 1 个顶点
+void buildCurveStencil(EvaluationStencil& stencil, int numControlPoints, int degree, int numSamples);
+
+// 仅在拓扑、次数或采样数变化时重建；返回是否发生了重建
+bool updateSurfaceStencil(EvaluationStencil& stencil, int rows, int cols,
+                          int degreeU, int degreeV, int uSamples, int vSamples);
+bool updateCurveStencil(EvaluationStencil& stencil, int numControlPoints, int degree, int numSamples);
+
+// 多项式求值：sum(c_k * P_k)
+std::vector<glm::vec3> applyStencil(const EvaluationStencil& stencil,
+                                    const std::vector<glm::vec3>& controlPoints);
+
+// 有理求值（齐次坐标）：sum(c_k * w_k * P_k) / sum(c_k * w_k)
+std::vector<glm::vec3> applyStencilRational(const EvaluationStencil& stencil,
+                                            const std::vector<glm::vec3>& controlPoints,
+                                            const std::vector<float>& weights);
+
+// 写入调用方缓冲区 out[0..capacity)：需要 stencil.vertexCount() 个元素，返回写入个数，容量不足时返回 0
+size_t applyStencil(const EvaluationStencil& stencil, const std::vector<glm::vec3>& controlPoints,
+                    glm::vec3* out, size_t capacity);
+size_t applyStencilRational(const EvaluationStencil& stencil, const std::vector<glm::vec3>& controlPoints,
+                            const std::vector<float>& weights, glm::vec3* out, size_t capacity);
+
+// 曲面细分缓存：保存每个采样点的齐次分子 (sum c*w*P) 与分母 (sum c*w)，
+// 单个控制点或权重变化时只修补其局部支撑覆盖的采样行列。
+// 多项式曲面（Bezier / B 样条）按权重全为 1 处理。
+struct SurfaceTessellation {
+    std::vector<glm::vec4> homogeneous; // xyz = 分子, w = 分母
+    std::vector<glm::vec3> positions;   // 投影后的顶点，行优先 (uSamples + 1) × (vSamples + 1)
+    Generation generation;              // 重建或局部更新后递增，供渲染器判断是否需要上传
+
+    // 自上次 clearTessellationDirty 以来被修改的采样范围 [uBegin, uEnd) × [vBegin, vEnd)
+    int dirtyUBegin = 0, dirtyUEnd = 0;
+    int dirtyVBegin = 0, dirtyVEnd = 0;
+
+    bool hasDirtyRange() const { return dirtyUBegin < dirtyUEnd && dirtyVBegin < dirtyVEnd; }
+};
+
+// 全量重建（拓扑/次数/采样数/曲面类型变化时使用），整个网格标记为脏
+void rebuildTessellation(SurfaceTessellation& mesh, const EvaluationStencil& stencil,
+                         const std::vector<glm::vec3>& controlPoints,
+                         const std::vector<float>& weights);
+
+// 直接读取连续控制网格（行优先下标与模板一致）；rational = false 时忽略网格中的权重
+void rebuildTessellation(SurfaceTessellation& mesh, const EvaluationStencil& stencil,
+                         const ControlNet& net, bool rational);
+
+// 控制点 (row, col) 由 (oldPoint, oldWeight) 变为 (newPoint, newWeight)：
+// 对其支撑范围内的采样点做增量修补，并将该范围并入脏区域
+void updateTessellationPoint(SurfaceTessellation& mesh, const EvaluationStencil& stencil,
+                             int row, int col,
+                             const glm::vec3& oldPoint, float oldWeight,
+                             const glm::vec3& newPoint, float newWeight);
+
+void clearTessellationDirty(SurfaceTessellation& mesh);
+
+// 一维基函数表中受控制点 index 影响的采样区间 [begin, end)
+void basisSupportRange(const BasisTable& table, int index, int& begin, int& end);
+
+} // namespace Spline
@@ -0,0 +1,352 @@
+#include "surface_raycast.h"
+#include "spline.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Spline {
+
+namespace {
+
+// 遍历栈深度上限：中位数划分的树高约为 log2(面片数 / kPatchLeafSize)
+constexpr int kMaxTraversalDepth = 64;
+// 每个面片的初值网格为 kSeedGrid × kSeedGrid 格（每格两个三角形）
+constexpr int kSeedGrid = 4;
+// 粗网格没有交点时，取离射线最近的这么多个采样点作为初值
+constexpr int kFallbackSeeds = 4;
+constexpr int kNewtonIterations = 12;
+// Newton 收敛后局部参数允许越出 [0, 1] 的量，越界更多的解属于相邻面片
+constexpr float kParamTolerance = 1e-4f;
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+// ========================
+// BVH
+// ========================
+void buildNode(PatchBVH& bvh, const std::vector<glm::vec3>& boundsMin, const std::vector<glm::vec3>& boundsMax,
+               const std::vector<glm::vec3>& centers, int nodeIndex, int begin, int end) {
+    glm::vec3 lo = boundsMin[bvh.order[begin]];
+    glm::vec3 hi = boundsMax[bvh.order[begin]];
+    for (int k = begin + 1; k < end; ++k) {
+        lo = glm::min(lo, boundsMin[bvh.order[k]]);
+        hi = glm::max(hi, boundsMax[bvh.order[k]]);
+    }
+    bvh.nodes[nodeIndex].boundsMin = lo;
+    bvh.nodes[nodeIndex].boundsMax = hi;
+    if (end - begin <= kPatchLeafSize) {
+        bvh.nodes[nodeIndex].first = begin;
+        bvh.nodes[nodeIndex].count = end - begin;
+        return;
+    }
+
+    // 按包围盒中心沿最长轴取中位数
+    glm::vec3 extent = hi - lo;
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(bvh.order.begin() + begin, bvh.order.begin() + mid, bvh.order.begin() + end,
+                     [&](int a, int b) { return centers[a][axis] < centers[b][axis]; });
+
+    int left = static_cast<int>(bvh.nodes.size());
+    bvh.nodes.resize(bvh.nodes.size() + 2);
+    bvh.nodes[nodeIndex].first = left;
+    bvh.nodes[nodeIndex].count = 0;
+    buildNode(bvh, boundsMin, boundsMax, centers, left, begin, mid);
+    buildNode(bvh, boundsMin, boundsMax, centers, left + 1, mid, end);
+}
+
+// 射线与包围盒的进入参数；不相交或整段在 tMax 之后时返回 +inf
+float intersectBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                      const glm::vec3& origin, const glm::vec3& invDir, float tMax) {
+    glm::vec3 t0 = (boundsMin - origin) * invDir;
+    glm::vec3 t1 = (boundsMax - origin) * invDir;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+    return enter <= exit ? enter : kInfinity;
+}
+
+// ========================
+// Patch Evaluation
+// ========================
+// 有理 Bezier 面片的点与一阶偏导，基函数缓冲按次数一次性分配
+class PatchEvaluator {
+public:
+    explicit PatchEvaluator(const BezierSurfacePatches& patches)
+        : degreeU(patches.degreeU), degreeV(patches.degreeV),
+          Bu(degreeU + 1), dBu(degreeU + 1), Bv(degreeV + 1), dBv(degreeV + 1),
+          lower(std::max(degreeU, degreeV) + 1) {}
+
+    // 局部参数 (s, t) ∈ [0,1]²
+    void evaluate(const glm::vec4* P, float s, float t, glm::vec3& S, glm::vec3& Su, glm::vec3& Sv) {
+        basis(degreeU, s, Bu.data(), dBu.data());
+        basis(degreeV, t, Bv.data(), dBv.data());
+        int orderV = degreeV + 1;
+        glm::vec4 H(0.0f), Hu(0.0f), Hv(0.0f);
+        for (int a = 0; a <= degreeU; ++a) {
+            glm::vec4 row(0.0f), rowDv(0.0f);
+            for (int b = 0; b < orderV; ++b) {
+                row += Bv[b] * P[a * orderV + b];
+                rowDv += dBv[b] * P[a * orderV + b];
+            }
+            H += Bu[a] * row;
+            Hu += dBu[a] * row;
+            Hv += Bu[a] * rowDv;
+        }
+        // 商的求导：(H.xyz / w)' = (H'.xyz - S·H'.w) / w
+        float w = std::abs(H.w) > 1e-6f ? H.w : 1.0f;
+        S = glm::vec3(H) / w;
+        Su = (glm::vec3(Hu) - S * Hu.w) / w;
+        Sv = (glm::vec3(Hv) - S * Hv.w) / w;
+    }
+
+private:
+    // B'_{i,n} = n · (B_{i-1,n-1} - B_{i,n-1})
+    void basis(int degree, float t, float* B, float* dB) {
+        bernsteinBasis(degree, t, B);
+        bernsteinBasis(degree - 1, t, lower.data());
+        for (int i = 0; i <= degree; ++i) {
+            float left = i > 0 ? lower[i - 1] : 0.0f;
+            float right = i < degree ? lower[i] : 0.0f;
+            dB[i] = degree * (left - right);
+        }
+    }
+
+    int degreeU, degreeV;
+    std::vector<float> Bu, dBu, Bv, dBv, lower;
+};
+
+// ========================
+// Ray–Patch Intersection
+// ========================
+struct Ray {
+    glm::vec3 origin, dir;
+    glm::vec3 n1, n2; // 两个包含射线的平面的单位法向：曲面点在射线上 ⇔ 到两平面的距离都为 0
+};
+
+// Möller–Trumbore，不剔除背面；命中时返回 t 与重心坐标 (b1, b2)
+bool intersectTriangle(const Ray& ray, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2,
+                       float& t, float& b1, float& b2) {
+    glm::vec3 e1 = p1 - p0, e2 = p2 - p0;
+    glm::vec3 pv = glm::cross(ray.dir, e2);
+    float det = glm::dot(e1, pv);
+    if (std::abs(det) < 1e-12f) return false;
+    float inv = 1.0f / det;
+    glm::vec3 tv = ray.origin - p0;
+    b1 = glm::dot(tv, pv) * inv;
+    if (b1 < 0.0f || b1 > 1.0f) return false;
+    glm::vec3 qv = glm::cross(tv, e1);
+    b2 = glm::dot(ray.dir, qv) * inv;
+    if (b2 < 0.0f || b1 + b2 > 1.0f) return false;
+    t = glm::dot(e2, qv) * inv;
+    return t >= 0.0f;
+}
+
+// 从局部参数 seed 出发做 Newton 迭代；收敛到面片内且在射线正方向时返回 true
+bool refineHit(PatchEvaluator& evaluator, const glm::vec4* P, const Ray& ray, float tolerance,
+               glm::vec2 seed, glm::vec2& local, glm::vec3& point, float& tHit) {
+    float s = seed.x, t = seed.y;
+    glm::vec3 S, Su, Sv;
+    bool converged = false;
+    for (int it = 0; it < kNewtonIterations; ++it) {
+        evaluator.evaluate(P, s, t, S, Su, Sv);
+        glm::vec3 r = S - ray.origin;
+        float f1 = glm::dot(ray.n1, r);
+        float f2 = glm::dot(ray.n2, r);
+        if (std::abs(f1) + std::abs(f2) < tolerance) {
+            converged = true;
+            break;
+        }
+        float j11 = glm::dot(ray.n1, Su), j12 = glm::dot(ray.n1, Sv);
+        float j21 = glm::dot(ray.n2, Su), j22 = glm::dot(ray.n2, Sv);
+        float det = j11 * j22 - j12 * j21;
+        if (std::abs(det) < 1e-12f) return false;
+        s -= (f1 * j22 - f2 * j12) / det;
+        t -= (j11 * f2 - j21 * f1) / det;
+        // 远离面片时放弃，交点若存在会由相邻面片找到
+        if (s < -0.5f || s > 1.5f || t < -0.5f || t > 1.5f) return false;
+    }
+    if (!converged) return false;
+    if (s < -kParamTolerance || s > 1.0f + kParamTolerance ||
+        t < -kParamTolerance || t > 1.0f + kParamTolerance) return false;
+
+    tHit = glm::dot(S - ray.origin, ray.dir) / glm::dot(ray.dir, ray.dir);
+    if (tHit < 0.0f) return false;
+    local = glm::clamp(glm::vec2(s, t), 0.0f, 1.0f);
+    point = S;
+    return true;
+}
+
+// 面片 k 上比 bestT 更近的交点
+bool intersectPatch(const BezierSurfacePatches& patches, PatchEvaluator& evaluator, int k, const Ray& ray,
+                    float bestT, SurfaceHit& hit) {
+    const glm::vec4* P = patches.patch(k);
+    constexpr int n = kSeedGrid + 1;
+    glm::vec3 samples[n * n];
+    glm::vec3 Su, Sv;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            evaluator.evaluate(P, static_cast<float>(i) / kSeedGrid, static_cast<float>(j) / kSeedGrid,
+                               samples[i * n + j], Su, Sv);
+        }
+    }
+
+    // 粗三角网格的交点作为 Newton 初值
+    glm::vec2 seeds[2 * kSeedGrid * kSeedGrid];
+    int seedCount = 0;
+    const float step = 1.0f / kSeedGrid;
+    for (int i = 0; i < kSeedGrid; ++i) {
+        for (int j = 0; j < kSeedGrid; ++j) {
+            glm::vec2 uv00(i * step, j * step);
+            const glm::vec3& p00 = samples[i * n + j];
+            const glm::vec3& p10 = samples[(i + 1) * n + j];
+            const glm::vec3& p01 = samples[i * n + j + 1];
+            const glm::vec3& p11 = samples[(i + 1) * n + j + 1];
+            float t, b1, b2;
+            if (intersectTriangle(ray, p00, p10, p01, t, b1, b2)) {
+                seeds[seedCount++] = uv00 + step * glm::vec2(b1, b2);
+            }
+            if (intersectTriangle(ray, p11, p01, p10, t, b1, b2)) {
+                seeds[seedCount++] = uv00 + step * glm::vec2(1.0f - b1, 1.0f - b2);
+            }
+        }
+    }
+    // 掠射时粗网格可能全部错过：以离射线最近的几个采样点为初值。
+    // 掠射的两个交点挨在切点两侧，只用一个初值时 Newton 可能收敛到较远的那个
+    if (seedCount == 0) {
+        glm::vec3 unitDir = glm::normalize(ray.dir);
+        float distance[n * n];
+        int nearest[n * n];
+        for (int k = 0; k < n * n; ++k) {
+            distance[k] = glm::length(glm::cross(samples[k] - ray.origin, unitDir));
+            nearest[k] = k;
+        }
+        std::partial_sort(nearest, nearest + kFallbackSeeds, nearest + n * n,
+                          [&](int a, int b) { return distance[a] < distance[b]; });
+        for (int k = 0; k < kFallbackSeeds; ++k) {
+            seeds[seedCount++] = glm::vec2(nearest[k] / n, nearest[k] % n) * step;
+        }
+    }
+
+    glm::vec3 diagonal = patches.boundsMax[k] - patches.boundsMin[k];
+    float tolerance = 1e-5f * std::max(1.0f, glm::length(diagonal));
+    bool found = false;
+    for (int s = 0; s < seedCount; ++s) {
+        glm::vec2 local;
+        glm::vec3 point;
+        float tHit;
+        if (!refineHit(evaluator, P, ray, tolerance, seeds[s], local, point, tHit) || tHit >= bestT) continue;
+        int pu = k / patches.patchCountV();
+        int pv = k % patches.patchCountV();
+        float u0 = patches.breakpointsU[pu], u1 = patches.breakpointsU[pu + 1];
+        float v0 = patches.breakpointsV[pv], v1 = patches.breakpointsV[pv + 1];
+        hit.t = tHit;
+        hit.uv = glm::vec2(u0 + local.x * (u1 - u0), v0 + local.y * (v1 - v0));
+        hit.point = point;
+        hit.patch = k;
+        bestT = tHit;
+        found = true;
+    }
+    return found;
+}
+
+} // namespace
+
+// ========================
+// 1. Patch BVH
+// ========================
+void buildPatchBVH(PatchBVH& bvh, const std::vector<glm::vec3>& boundsMin, const std::vector<glm::vec3>& boundsMax) {
+    size_t count = std::min(boundsMin.size(), boundsMax.size());
+    bvh.nodes.clear();
+    bvh.order.resize(count);
+    for (size_t k = 0; k < count; ++k) bvh.order[k] = static_cast<int>(k);
+    if (count == 0) return;
+
+    std::vector<glm::vec3> centers(count);
+    for (size_t k = 0; k < count; ++k) centers[k] = 0.5f * (boundsMin[k] + boundsMax[k]);
+    bvh.nodes.reserve(2 * (count / kPatchLeafSize + 1));
+    bvh.nodes.emplace_back();
+    buildNode(bvh, boundsMin, boundsMax, centers, 0, 0, static_cast<int>(count));
+}
+
+void buildPatchBVH(PatchBVH& bvh, const BezierSurfacePatches& patches) {
+    buildPatchBVH(bvh, patches.boundsMin, patches.boundsMax);
+}
+
+void buildPatchBVH(PatchBVH& bvh, const BezierCurveSegments& segments) {
+    buildPatchBVH(bvh, segments.boundsMin, segments.boundsMax);
+}
+
+// ========================
+// 2. Ray Query
+// ========================
+bool intersectSurface(const BezierSurfacePatches& patches, const PatchBVH& bvh,
+                      const glm::vec3& origin, const glm::vec3& dir, SurfaceHit& hit) {
+    if (bvh.empty() || bvh.order.size() != patches.patchCount()) return false;
+    float dirLength = glm::length(dir);
+    if (!(dirLength > 0.0f)) return false;
+
+    Ray ray;
+    ray.origin = origin;
+    ray.dir = dir;
+    glm::vec3 unitDir = dir / dirLength;
+    glm::vec3 axis = std::abs(unitDir.x) > std::abs(unitDir.z) ? glm::vec3(-unitDir.y, unitDir.x, 0.0f)
+                                                               : glm::vec3(0.0f, -unitDir.z, unitDir.y);
+    ray.n1 = glm::normalize(axis);
+    ray.n2 = glm::cross(unitDir, ray.n1);
+    glm::vec3 invDir = 1.0f / dir;
+
+    PatchEvaluator evaluator(patches);
+    float bestT = kInfinity;
+    bool found = false;
+
+    struct Entry {
+        int node;
+        float tEnter;
+    };
+    Entry stack[kMaxTraversalDepth];
+    int top = 0;
+    float rootT = intersectBounds(bvh.nodes[0].boundsMin, bvh.nodes[0].boundsMax, origin, invDir, bestT);
+    if (rootT == kInfinity) return false;
+    stack[top++] = {0, rootT};
+
+    while (top > 0) {
+        Entry e = stack[--top];
+        if (e.tEnter > bestT) continue; // 已有更近的交点
+        const PatchBVH::Node& node = bvh.nodes[e.node];
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                int k = bvh.order[i];
+                if (intersectBounds(patches.boundsMin[k], patches.boundsMax[k], origin, invDir, bestT) == kInfinity) {
+                    continue;
+                }
+                if (intersectPatch(patches, evaluator, k, ray, bestT, hit)) {
+                    bestT = hit.t;
+                    found = true;
+                }
+            }
+            continue;
+        }
+        // 近的子节点后入栈、先出栈
+        const PatchBVH::Node& leftNode = bvh.nodes[node.first];
+        const PatchBVH::Node& rightNode = bvh.nodes[node.first + 1];
+        Entry l{node.first, intersectBounds(leftNode.boundsMin, leftNode.boundsMax, origin, invDir, bestT)};
+        Entry r{node.first + 1, intersectBounds(rightNode.boundsMin, rightNode.boundsMax, origin, invDir, bestT)};
+        if (l.tEnter > r.tEnter) std::swap(l, r);
+        if (r.tEnter != kInfinity && top < kMaxTraversalDepth) stack[top++] = r;
+        if (l.tEnter != kInfinity && top < kMaxTraversalDepth) stack[top++] = l;
+    }
+    return found;
+}
+
+bool raycastSurface(SurfaceRaycastCache& cache, const ControlNet& net, bool rational, int degreeU, int degreeV,
+                    const glm::vec3& origin, const glm::vec3& dir, SurfaceHit& hit) {
+    const BezierSurfacePatches& patches = getBezierPatches(cache.patches, net, rational, degreeU, degreeV);
+    if (cache.bvhGeneration != cache.patches.generation) {
+        buildPatchBVH(cache.bvh, patches);
+        cache.bvhGeneration = cache.patches.generation;
+    }
+    return intersectSurface(patches, cache.bvh, origin, dir, hit);
+}
+
+} // namespace Spline
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "bezier_extraction.h"
+
+namespace Spline {
+
+// 叶子最多包含的面片数
+constexpr int kPatchLeafSize = 4;
+
+// Bezier 面片凸包包围盒上的 BVH：权重为正时面片落在其控制点凸包内，射线未穿过包围盒的面片不必求交。
+// 同样的结构也用于曲线段（见 point_projection.h）
+struct PatchBVH {
+    struct Node {
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+        int first = 0;  // 叶子：在 order 中的起始位置；内部节点：左子节点下标（右子节点为 first + 1）
+        int count = 0;  // 叶子的面片数，内部节点为 0
+    };
+
+    std::vector<Node> nodes;  // nodes[0] 为根
+    std::vector<int> order;   // 叶子顺序下的面片下标
+
+    bool empty() const { return order.empty(); }
+};
+
+// 第 k 个元素的包围盒为 [boundsMin[k], boundsMax[k]]，order 中存放的是元素下标
+void buildPatchBVH(PatchBVH& bvh, const std::vector<glm::vec3>& boundsMin, const std::vector<glm::vec3>& boundsMax);
+void buildPatchBVH(PatchBVH& bvh, const BezierSurfacePatches& patches);
+void buildPatchBVH(PatchBVH& bvh, const BezierCurveSegments& segments);
+
+struct SurfaceHit {
+    float t = 0.0f;                   // 交点 = origin + t·dir
+    glm::vec2 uv = glm::vec2(0.0f);   // 全局曲面参数，与 evaluate*Surface 的 (u, v) 相同
+    glm::vec3 point = glm::vec3(0.0f);
+    int patch = -1;
+};
+
+// 射线 origin + t·dir（t >= 0）与曲面的最近交点。
+// 按进入距离由近到远遍历 BVH；每个候选面片先与 4 × 4 格的粗三角网格求交得到初值，
+// 再对 (u, v) 做 Newton 迭代，使曲面点落在射线上（两个包含射线的平面上的残差为 0）。
+// 粗网格漏掉的掠射交点以离射线最近的几个采样点为初值再试一次
+bool intersectSurface(const BezierSurfacePatches& patches, const PatchBVH& bvh,
+                      const glm::vec3& origin, const glm::vec3& dir, SurfaceHit& hit);
+
+// 面片形式与 BVH 一起缓存：控制网格、次数或有理性不变时直接复用，每次查询只做遍历和 Newton 迭代
+struct SurfaceRaycastCache {
+    BezierPatchCache patches;
+    PatchBVH bvh;
+    uint64_t bvhGeneration = 0; // 构建 bvh 时 patches.generation 的值
+};
+
+bool raycastSurface(SurfaceRaycastCache& cache, const ControlNet& net, bool rational, int degreeU, int degreeV,
+                    const glm::vec3& origin, const glm::vec3& dir, SurfaceHit& hit);
+
+} // namespace Spline
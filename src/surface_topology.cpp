@@ -0,0 +1,108 @@
+#include "surface_topology.h"
+#include "spline.h"
+#include <algorithm>
+
+namespace Spline {
+
+namespace {
+
+// 四边形 (i, j) 的两个三角形，朝向与 generateSurfaceIndices 相同
+void appendQuad(std::vector<uint32_t>& out, int i, int j, int vSamples) {
+    uint32_t topLeft = static_cast<uint32_t>(i * (vSamples + 1) + j);
+    uint32_t topRight = topLeft + 1;
+    uint32_t bottomLeft = static_cast<uint32_t>((i + 1) * (vSamples + 1) + j);
+    uint32_t bottomRight = bottomLeft + 1;
+    out.insert(out.end(), {topLeft, bottomLeft, topRight, topRight, bottomLeft, bottomRight});
+}
+
+// 0, stride, 2·stride, ..., 以及末尾的 count（等参线总是包含边界）
+std::vector<int> strideLines(int count, int stride) {
+    std::vector<int> lines;
+    for (int k = 0; k < count; k += stride) lines.push_back(k);
+    lines.push_back(count);
+    return lines;
+}
+
+} // namespace
+
+SurfaceTopology buildSurfaceTopology(int uSamples, int vSamples, IndexLayout layout, int lineStride) {
+    SurfaceTopology topology;
+    topology.uSamples = uSamples;
+    topology.vSamples = vSamples;
+    topology.layout = layout;
+    // 单行 / 单列网格没有三角形，但仍有网格线
+    bool lines = layout == IndexLayout::GridLines;
+    topology.lineStride = lines ? std::max(1, lineStride) : 1;
+    if (uSamples < 0 || vSamples < 0 || (!lines && (uSamples == 0 || vSamples == 0))) return topology;
+
+    size_t vertexCount = static_cast<size_t>(uSamples + 1) * (vSamples + 1);
+    topology.compact = vertexCount <= 0xFFFF;
+    uint32_t restart = topology.restartIndex();
+
+    std::vector<uint32_t>& indices = topology.indices32;
+    switch (layout) {
+    case IndexLayout::Triangles:
+        indices.resize(surfaceIndexCount(uSamples, vSamples));
+        generateSurfaceIndices(uSamples, vSamples, indices.data(), indices.size());
+        break;
+    case IndexLayout::CacheOptimized:
+        indices.reserve(surfaceIndexCount(uSamples, vSamples));
+        for (int j0 = 0; j0 < vSamples; j0 += kCacheBandWidth) {
+            int j1 = std::min(j0 + kCacheBandWidth, vSamples);
+            for (int i = 0; i < uSamples; ++i) {
+                for (int j = j0; j < j1; ++j) appendQuad(indices, i, j, vSamples);
+            }
+        }
+        break;
+    case IndexLayout::TriangleStrips:
+        // 上下两行交替：(i, j), (i + 1, j), ... 奇数三角形由 GL 翻转，朝向与三角形列表一致
+        indices.reserve(static_cast<size_t>(uSamples) * (2 * (vSamples + 1) + 1));
+        for (int i = 0; i < uSamples; ++i) {
+            if (i > 0) indices.push_back(restart);
+            for (int j = 0; j <= vSamples; ++j) {
+                indices.push_back(static_cast<uint32_t>(i * (vSamples + 1) + j));
+                indices.push_back(static_cast<uint32_t>((i + 1) * (vSamples + 1) + j));
+            }
+        }
+        break;
+    case IndexLayout::GridLines: {
+        std::vector<int> rows = strideLines(uSamples, topology.lineStride);
+        std::vector<int> cols = strideLines(vSamples, topology.lineStride);
+        indices.reserve(static_cast<size_t>(2) * (rows.size() * vSamples + cols.size() * uSamples));
+        for (int i : rows) {
+            for (int j = 0; j < vSamples; ++j) {
+                uint32_t a = static_cast<uint32_t>(i * (vSamples + 1) + j);
+                indices.insert(indices.end(), {a, a + 1});
+            }
+        }
+        for (int j : cols) {
+            for (int i = 0; i < uSamples; ++i) {
+                uint32_t a = static_cast<uint32_t>(i * (vSamples + 1) + j);
+                indices.insert(indices.end(), {a, a + static_cast<uint32_t>(vSamples + 1)});
+            }
+        }
+        break;
+    }
+    }
+
+    if (topology.compact) {
+        topology.indices16.assign(indices.begin(), indices.end());
+        std::vector<uint32_t>().swap(indices);
+    }
+    return topology;
+}
+
+const SurfaceTopology& getSurfaceTopology(SurfaceTopologyCache& cache, int uSamples, int vSamples,
+                                          IndexLayout layout, int lineStride) {
+    lineStride = layout == IndexLayout::GridLines ? std::max(1, lineStride) : 1;
+    for (const SurfaceTopology& topology : cache.entries) {
+        if (topology.uSamples == uSamples && topology.vSamples == vSamples && topology.layout == layout &&
+            topology.lineStride == lineStride) {
+            return topology;
+        }
+    }
+    cache.entries.push_back(buildSurfaceTopology(uSamples, vSamples, layout, lineStride));
+    return cache.entries.back();
+}
+
+} // namespace Spline
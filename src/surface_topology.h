@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace Spline {
+
+// 曲面采样网格 (uSamples + 1) × (vSamples + 1)（行优先）的索引拓扑，只由采样数和布局决定
+enum class IndexLayout {
+    Triangles,      // 三角形列表，逐行扫描（与 generateSurfaceIndices 相同）
+    CacheOptimized, // 三角形列表，按 kCacheBandWidth 列宽的竖条带逐行扫描，相邻行共享的顶点仍在后变换缓存中
+    TriangleStrips, // 每行一条三角形带，行间以图元重启索引分隔
+    GridLines,      // GL_LINES 线段对：先逐行连接相邻列，再逐列连接相邻行（控制网格 / 细分线框）；
+                    // lineStride > 1 时只取每隔 lineStride 的行列（含边界），即等参线
+};
+
+// 条带内一行 kCacheBandWidth + 1 个顶点，加上下一行的同样数量，小于常见的后变换缓存容量
+constexpr int kCacheBandWidth = 12;
+
+// 三种三角形布局的朝向一致。rows × cols 的控制网格对应 uSamples = rows - 1, vSamples = cols - 1。
+// 顶点数不超过 0xFFFF 时使用 16 位索引（0xFFFF 保留为重启索引）
+struct SurfaceTopology {
+    int uSamples = 0, vSamples = 0;
+    IndexLayout layout = IndexLayout::Triangles;
+    int lineStride = 1;             // 仅 GridLines 使用
+    bool compact = false;           // true 时索引在 indices16 中，否则在 indices32 中
+    std::vector<uint16_t> indices16;
+    std::vector<uint32_t> indices32;
+
+    size_t indexCount() const { return compact ? indices16.size() : indices32.size(); }
+    size_t indexSize() const { return compact ? sizeof(uint16_t) : sizeof(uint32_t); }
+    const void* data() const {
+        return compact ? static_cast<const void*>(indices16.data()) : static_cast<const void*>(indices32.data());
+    }
+    bool isStrip() const { return layout == IndexLayout::TriangleStrips; }
+    bool isLines() const { return layout == IndexLayout::GridLines; }
+    uint32_t restartIndex() const { return compact ? 0xFFFFu : 0xFFFFFFFFu; }
+};
+
+SurfaceTopology buildSurfaceTopology(int uSamples, int vSamples, IndexLayout layout, int lineStride = 1);
+
+// 按 (uSamples, vSamples, layout, lineStride) 缓存的拓扑：每组参数只生成一次，返回的引用在缓存存续期间有效
+struct SurfaceTopologyCache {
+    std::deque<SurfaceTopology> entries;
+};
+
+const SurfaceTopology& getSurfaceTopology(SurfaceTopologyCache& cache, int uSamples, int vSamples,
+                                          IndexLayout layout, int lineStride = 1);
+
+} // namespace Spline
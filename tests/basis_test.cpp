@@ -0,0 +1,119 @@
+// 节点区间基函数引擎的差分测试：findKnotSpan / basisFunctions 与递归 Cox-de Boor 定义一致，
+// 曲线与曲面求值与按定义求和的结果一致，u = 1 处插值末端控制点
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-4f;
+
+// 递归定义（区间左闭右开），0/0 按 0 处理
+double coxDeBoor(int i, int p, double u, const std::vector<float>& knots) {
+    if (p == 0) return (knots[i] <= u && u < knots[i + 1]) ? 1.0 : 0.0;
+    double left = 0.0, right = 0.0;
+    double leftSpan = knots[i + p] - knots[i];
+    double rightSpan = knots[i + p + 1] - knots[i + 1];
+    if (leftSpan > 0.0) left = (u - knots[i]) / leftSpan * coxDeBoor(i, p - 1, u, knots);
+    if (rightSpan > 0.0) right = (knots[i + p + 1] - u) / rightSpan * coxDeBoor(i + 1, p - 1, u, knots);
+    return left + right;
+}
+
+void testBasisFunctions(std::mt19937& rng) {
+    std::uniform_real_distribution<float> param(0.0f, 1.0f);
+    for (int degree = 1; degree <= 7; ++degree) {
+        int numControlPoints = degree + 1 + static_cast<int>(rng() % 10);
+        auto knots = Test::randomClampedKnots(rng, numControlPoints, degree);
+        std::vector<float> N(degree + 1);
+        double worst = 0.0;
+        for (int s = 0; s < 200; ++s) {
+            float u = s == 0 ? 0.0f : param(rng);
+            int span = findKnotSpan(numControlPoints, degree, u, knots);
+            TEST_CHECK(span >= degree && span < numControlPoints);
+            TEST_CHECK(knots[span] <= u && u < knots[span + 1]);
+
+            basisFunctions(span, u, degree, knots, N.data());
+            double sum = 0.0;
+            for (int a = 0; a <= degree; ++a) {
+                worst = std::max(worst, std::abs(N[a] - coxDeBoor(span - degree + a, degree, u, knots)));
+                sum += N[a];
+            }
+            TEST_CHECK(std::abs(sum - 1.0) <= 1e-5);
+        }
+        TEST_CHECK(worst <= 1e-5);
+
+        // u = 1 落在最后一个非空区间，只有最后一个基函数非零
+        int last = findKnotSpan(numControlPoints, degree, 1.0f, knots);
+        TEST_CHECK(last == numControlPoints - 1);
+        basisFunctions(last, 1.0f, degree, knots, N.data());
+        TEST_CHECK(std::abs(N[degree] - 1.0f) <= 1e-6f);
+    }
+}
+
+// 与求值函数相同的均匀钳位节点，逐点按递归定义求和
+glm::vec3 coxDeBoorCurvePoint(const std::vector<glm::vec3>& points, const std::vector<float>& weights,
+                              int degree, float u) {
+    int n = static_cast<int>(points.size());
+    auto knots = generateClampedKnotVector(n, degree);
+    glm::dvec3 numerator(0.0);
+    double denominator = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double b = coxDeBoor(i, degree, u, knots) * (weights.empty() ? 1.0 : weights[i]);
+        numerator += b * glm::dvec3(points[i]);
+        denominator += b;
+    }
+    return glm::vec3(numerator / denominator);
+}
+
+void testCurves(std::mt19937& rng) {
+    for (int degree = 1; degree <= 7; ++degree) {
+        int numControlPoints = degree + 5;
+        const int numSamples = 40;
+        auto points = Test::randomPoints(rng, numControlPoints);
+        auto weights = Test::randomWeights(rng, numControlPoints);
+        std::vector<glm::vec3> reference(numSamples + 1), rationalReference(numSamples + 1);
+        for (int s = 0; s < numSamples; ++s) {
+            float u = static_cast<float>(s) / numSamples;
+            reference[s] = coxDeBoorCurvePoint(points, {}, degree, u);
+            rationalReference[s] = coxDeBoorCurvePoint(points, weights, degree, u);
+        }
+        reference[numSamples] = rationalReference[numSamples] = points.back();
+        TEST_CLOSE(evaluateBSpline(points, degree, numSamples), reference, kTolerance);
+        TEST_CLOSE(evaluateNURBS(points, weights, degree, numSamples), rationalReference, kTolerance);
+    }
+}
+
+// 曲面的四条边界插值角点，远端（u = 1 / v = 1）的行列不退化
+void testSurfaceBoundaries(std::mt19937& rng) {
+    const int rows = 6, cols = 5, uSamples = 12, vSamples = 9;
+    auto grid = Test::randomGrid(rng, rows, cols);
+    auto weights = Test::randomWeightGrid(rng, rows, cols);
+    for (int degree = 1; degree <= 3; ++degree) {
+        auto polynomial = evaluateBSplineSurface(grid, degree, degree, uSamples, vSamples);
+        auto rational = evaluateNURBSSurface(grid, weights, degree, degree, uSamples, vSamples);
+        TEST_CLOSE(polynomial, Test::referenceSurface(grid, {}, degree, degree, uSamples, vSamples), kTolerance);
+        TEST_CLOSE(rational, Test::referenceSurface(grid, weights, degree, degree, uSamples, vSamples), kTolerance);
+
+        auto at = [&](const std::vector<glm::vec3>& surface, int i, int j) { return surface[i * (vSamples + 1) + j]; };
+        for (const auto* surface : {&polynomial, &rational}) {
+            TEST_CHECK(glm::length(at(*surface, 0, 0) - grid[0][0]) <= 1e-5f);
+            TEST_CHECK(glm::length(at(*surface, 0, vSamples) - grid[0][cols - 1]) <= 1e-5f);
+            TEST_CHECK(glm::length(at(*surface, uSamples, 0) - grid[rows - 1][0]) <= 1e-5f);
+            TEST_CHECK(glm::length(at(*surface, uSamples, vSamples) - grid[rows - 1][cols - 1]) <= 1e-5f);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240601);
+    testBasisFunctions(rng);
+    testCurves(rng);
+    testSurfaceBoundaries(rng);
+    return Test::finish("basis_test");
+}
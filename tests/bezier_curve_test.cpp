@@ -0,0 +1,92 @@
+// Bezier 曲线求值的差分测试：Horner 路径（含 100~500 次）与双精度 de Casteljau 一致；
+// 超过 512 次的自适应细分路径插值端点、不超过 bezierOutputSize，且每个输出点都落在曲线上
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-5f;
+
+glm::dvec3 deCasteljau(const std::vector<glm::vec3>& controlPoints, double t) {
+    std::vector<glm::dvec3> points(controlPoints.begin(), controlPoints.end());
+    for (size_t k = points.size() - 1; k > 0; --k) {
+        for (size_t i = 0; i < k; ++i) points[i] = (1.0 - t) * points[i] + t * points[i + 1];
+    }
+    return points[0];
+}
+
+std::vector<glm::vec3> referenceBezier(const std::vector<glm::vec3>& controlPoints, int numSamples) {
+    std::vector<glm::vec3> curve(numSamples + 1);
+    for (int s = 0; s <= numSamples; ++s) {
+        curve[s] = glm::vec3(deCasteljau(controlPoints, static_cast<double>(s) / numSamples));
+    }
+    return curve;
+}
+
+// ========================
+// 1. Horner 路径
+// ========================
+void testHorner(std::mt19937& rng) {
+    for (int degree : {1, 2, 3, 5, 8, 12, 100, 150, 200, 500}) {
+        auto points = Test::randomPoints(rng, degree + 1);
+        const int numSamples = 64;
+        TEST_CHECK(bezierOutputSize(degree + 1, numSamples) == static_cast<size_t>(numSamples + 1));
+        auto curve = evaluateBezier(points, numSamples);
+        TEST_CLOSE(curve, referenceBezier(points, numSamples), kTolerance);
+        TEST_CHECK(curve.front() == points.front());
+        TEST_CHECK(glm::length(curve.back() - points.back()) <= 1e-6f);
+    }
+}
+
+// ========================
+// 2. 自适应细分路径（次数 > 512）
+// ========================
+// 细分点都位于二进参数 k / 2^depth 上：按顺序与该分辨率下的参考点逐一匹配
+void checkAdaptiveCurve(const std::vector<glm::vec3>& points, int numSamples) {
+    int numControlPoints = static_cast<int>(points.size());
+    size_t capacity = bezierOutputSize(numControlPoints, numSamples);
+    std::vector<glm::vec3> out(capacity);
+    size_t count = evaluateBezier(points, numSamples, out.data(), out.size());
+    TEST_CHECK(count >= 2 && count <= capacity);
+    TEST_CHECK(evaluateBezier(points, numSamples, out.data(), capacity - 1) == 0);
+    evaluateBezier(points, numSamples, out.data(), out.size());
+    TEST_CHECK(out[0] == points.front());
+    TEST_CHECK(out[count - 1] == points.back());
+
+    int resolution = static_cast<int>(capacity) - 1;
+    auto reference = referenceBezier(points, resolution);
+    int k = 0;
+    bool onCurve = true;
+    for (size_t i = 0; i < count && onCurve; ++i) {
+        while (k <= resolution && glm::length(out[i] - reference[k]) > kTolerance) ++k;
+        onCurve = k <= resolution;
+        ++k;
+    }
+    TEST_CHECK(onCurve);
+}
+
+void testAdaptive(std::mt19937& rng) {
+    checkAdaptiveCurve(Test::randomPoints(rng, 601), 64);
+    checkAdaptiveCurve(Test::randomPoints(rng, 1025), 100);
+
+    // 共线等距的控制点：整条曲线一次即判为平直，只输出两个端点
+    std::vector<glm::vec3> line(700);
+    for (size_t i = 0; i < line.size(); ++i) line[i] = glm::vec3(static_cast<float>(i) / 699.0f, 0.5f, -0.25f);
+    auto curve = evaluateBezier(line, 64);
+    TEST_CHECK(curve.size() == 2);
+    checkAdaptiveCurve(line, 64);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240607);
+    testHorner(rng);
+    testAdaptive(rng);
+    return Test::finish("bezier_curve_test");
+}
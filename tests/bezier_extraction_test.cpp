@@ -0,0 +1,64 @@
+// Bezier 抽取（A5.6）差分测试：分段 / 面片形式细分后与直接按定义求和的标量参考一致，
+// 凸包包围盒包含对应的曲线段
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "bezier_extraction.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-4f;
+
+void testCurveSegments(std::mt19937& rng) {
+    for (int degree = 1; degree <= 6; ++degree) {
+        int numControlPoints = degree + 6;
+        auto points = Test::randomPoints(rng, numControlPoints);
+        auto weights = Test::randomWeights(rng, numControlPoints);
+
+        auto polynomial = extractBezierSegments(points, {}, degree);
+        auto rational = extractBezierSegments(points, weights, degree);
+        TEST_CHECK(polynomial.segmentCount() == static_cast<size_t>(numControlPoints - degree));
+        TEST_CHECK(rational.segmentCount() == polynomial.segmentCount());
+        TEST_CLOSE(tessellateBezierSegments(polynomial, 97), Test::referenceCurve(points, {}, degree, 97), kTolerance);
+        TEST_CLOSE(tessellateBezierSegments(rational, 97), Test::referenceCurve(points, weights, degree, 97), kTolerance);
+
+        // 每段的包围盒包含该段参数区间内的曲线点
+        for (size_t k = 0; k < rational.segmentCount(); ++k) {
+            for (int s = 0; s <= 8; ++s) {
+                float u = rational.breakpoints[k] + (rational.breakpoints[k + 1] - rational.breakpoints[k]) * s / 8.0f;
+                glm::vec3 p = Test::referenceCurvePoint(points, weights, degree, u);
+                TEST_CHECK(glm::all(glm::greaterThanEqual(p, rational.boundsMin[k] - glm::vec3(1e-5f))) &&
+                           glm::all(glm::lessThanEqual(p, rational.boundsMax[k] + glm::vec3(1e-5f))));
+            }
+        }
+    }
+}
+
+void testSurfacePatches(std::mt19937& rng) {
+    const int rows = 7, cols = 9;
+    auto grid = Test::randomGrid(rng, rows, cols);
+    auto weights = Test::randomWeightGrid(rng, rows, cols);
+    for (int degreeU = 1; degreeU <= 4; ++degreeU) {
+        int degreeV = 5 - degreeU;
+        auto patches = extractBezierPatches(grid, {}, degreeU, degreeV);
+        auto rationalPatches = extractBezierPatches(grid, weights, degreeU, degreeV);
+        TEST_CHECK(patches.patchCount() == static_cast<size_t>((rows - degreeU) * (cols - degreeV)));
+        TEST_CLOSE(tessellateBezierPatches(patches, 23, 31),
+                   Test::referenceSurface(grid, {}, degreeU, degreeV, 23, 31), kTolerance);
+        TEST_CLOSE(tessellateBezierPatches(rationalPatches, 23, 31),
+                   Test::referenceSurface(grid, weights, degreeU, degreeV, 23, 31), kTolerance);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240612);
+    testCurveSegments(rng);
+    testSurfacePatches(rng);
+    return Test::finish("bezier_extraction_test");
+}
@@ -0,0 +1,130 @@
+// 编译期定长次数内核（1..kMaxFixedDegree 次）的差分测试：与运行时次数的 findKnotSpan / basisFunctions
+// 逐采样一致（含非均匀、重节点），并经 evaluateBSpline / evaluateNURBS / buildBasisTable 的稀疏采样路由
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "spline_fixed.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-5f;
+
+// 运行时次数的逐采样参考：每个采样独立二分查找节点区间
+glm::vec3 genericCurvePoint(const std::vector<glm::vec3>& points, const std::vector<float>& weights,
+                            int degree, const std::vector<float>& knots, float u) {
+    int n = static_cast<int>(points.size());
+    int span = findKnotSpan(n, degree, u, knots);
+    std::vector<float> N(degree + 1);
+    basisFunctions(span, u, degree, knots, N.data());
+    glm::vec3 numerator(0.0f);
+    float denominator = 0.0f;
+    for (int a = 0; a <= degree; ++a) {
+        float b = N[a] * (weights.empty() ? 1.0f : weights[span - degree + a]);
+        numerator += b * points[span - degree + a];
+        denominator += b;
+    }
+    return numerator / denominator;
+}
+
+// ========================
+// 1. 定长内核 vs 运行时次数实现
+// ========================
+void testKernels(std::mt19937& rng) {
+    for (int degree = 1; degree <= kMaxFixedDegree; ++degree) {
+        int numControlPoints = degree + 4 + static_cast<int>(rng() % 8);
+        const int numSamples = 57;
+        auto points = Test::randomPoints(rng, numControlPoints);
+        auto weights = Test::randomWeights(rng, numControlPoints);
+        auto knots = Test::randomClampedKnots(rng, numControlPoints, degree);
+
+        std::vector<glm::vec3> polynomial(numSamples), rational(numSamples);
+        std::vector<int> first(numSamples + 1);
+        std::vector<float> values(static_cast<size_t>(numSamples + 1) * (degree + 1));
+        TEST_CHECK(dispatchDegree(degree, [&](auto P) {
+            constexpr int kDegree = decltype(P)::value;
+            evaluateCurveFixed<kDegree>(points.data(), nullptr, numControlPoints, knots.data(), numSamples,
+                                        polynomial.data());
+            evaluateCurveFixed<kDegree>(points.data(), weights.data(), numControlPoints, knots.data(), numSamples,
+                                        rational.data());
+            fillBasisTableFixed<kDegree>(numControlPoints, knots.data(), numSamples, first.data(), values.data());
+
+            // 定长加权求和与手写循环一致
+            float c[kDegree + 1];
+            glm::vec3 expected(0.0f);
+            for (int a = 0; a <= kDegree; ++a) {
+                c[a] = values[a];
+                expected += c[a] * points[a];
+            }
+            TEST_CHECK(glm::length(weightedSumFixed<kDegree + 1>(c, points.data()) - expected) <= 1e-6f);
+        }));
+
+        std::vector<float> N(degree + 1);
+        float worst = 0.0f;
+        for (int s = 0; s <= numSamples; ++s) {
+            float u = static_cast<float>(s) / numSamples;
+            int span = findKnotSpan(numControlPoints, degree, u, knots);
+            basisFunctions(span, u, degree, knots, N.data());
+            TEST_CHECK(first[s] == span - degree);
+            for (int a = 0; a <= degree; ++a) {
+                worst = std::max(worst, std::abs(values[static_cast<size_t>(s) * (degree + 1) + a] - N[a]));
+            }
+            if (s == numSamples) break;
+            TEST_CHECK(glm::length(polynomial[s] - genericCurvePoint(points, {}, degree, knots, u)) <= kTolerance);
+            TEST_CHECK(glm::length(rational[s] - genericCurvePoint(points, weights, degree, knots, u)) <= kTolerance);
+        }
+        TEST_CHECK(worst <= 1e-6f);
+    }
+    TEST_CHECK(!dispatchDegree(0, [](auto) {}));
+    TEST_CHECK(!dispatchDegree(kMaxFixedDegree + 1, [](auto) {}));
+}
+
+// ========================
+// 2. 稀疏采样的公开入口（不走幂基 / 批量内核）
+// ========================
+void testRouting(std::mt19937& rng) {
+    for (int degree = 1; degree <= kMaxFixedDegree; ++degree) {
+        int numControlPoints = degree + 6;
+        int numSamples = 2 * numControlPoints;
+        auto points = Test::randomPoints(rng, numControlPoints);
+        auto weights = Test::randomWeights(rng, numControlPoints);
+        TEST_CLOSE(evaluateBSpline(points, degree, numSamples),
+                   Test::referenceCurve(points, {}, degree, numSamples), 1e-4f);
+        TEST_CLOSE(evaluateNURBS(points, weights, degree, numSamples),
+                   Test::referenceCurve(points, weights, degree, numSamples), 1e-4f);
+
+        // 权重全为零时分母退化，回退为非有理组合
+        std::vector<float> zeros(numControlPoints, 0.0f);
+        TEST_CLOSE(evaluateNURBS(points, zeros, degree, numSamples), evaluateBSpline(points, degree, numSamples),
+                   kTolerance);
+
+        auto table = buildBasisTable(numControlPoints, degree, numSamples);
+        auto knots = generateClampedKnotVector(numControlPoints, degree);
+        TEST_CHECK(table.order == degree + 1);
+        TEST_CHECK(table.first.size() == static_cast<size_t>(numSamples + 1));
+        std::vector<float> N(degree + 1);
+        float worst = 0.0f;
+        for (int s = 0; s <= numSamples; ++s) {
+            float u = static_cast<float>(s) / numSamples;
+            int span = findKnotSpan(numControlPoints, degree, u, knots);
+            basisFunctions(span, u, degree, knots, N.data());
+            TEST_CHECK(table.first[s] == span - degree);
+            for (int a = 0; a <= degree; ++a) {
+                worst = std::max(worst, std::abs(table.values[static_cast<size_t>(s) * table.order + a] - N[a]));
+            }
+        }
+        TEST_CHECK(worst <= 1e-6f);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240610);
+    testKernels(rng);
+    testRouting(rng);
+    return Test::finish("fixed_degree_test");
+}
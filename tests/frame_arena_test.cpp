@@ -0,0 +1,76 @@
+// 帧级分配器测试：highWaterMark() 记录实际单帧用量（不含主缓冲未用尾部），
+// 溢出后 reset() 扩容到能容纳整帧，同样的分配序列下一帧不再溢出
+#include <cstdint>
+#include <cstdio>
+#include "frame_arena.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+bool aligned(void* p, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+void testHighWaterMark() {
+    FrameArena arena(1024);
+    TEST_CHECK(arena.allocate(96, 8) != nullptr);
+    TEST_CHECK(arena.used() == 96);
+    TEST_CHECK(arena.highWaterMark() == 96);
+
+    // 放不下时走溢出块：峰值只计入已用部分与溢出块，不把主缓冲剩余的 928 字节算进去
+    TEST_CHECK(arena.allocate(2000, 8) != nullptr);
+    TEST_CHECK(arena.overflowCount() == 1);
+    TEST_CHECK(arena.used() == 2096);
+    TEST_CHECK(arena.highWaterMark() == 2096);
+
+    // 扩容后同一序列不再溢出，峰值保持为历史最大
+    arena.reset();
+    TEST_CHECK(arena.used() == 0);
+    TEST_CHECK(arena.overflowCount() == 0);
+    TEST_CHECK(arena.capacity() >= 1024 + 2000);
+    TEST_CHECK(arena.allocate(96, 8) != nullptr);
+    TEST_CHECK(arena.allocate(2000, 8) != nullptr);
+    TEST_CHECK(arena.overflowCount() == 0);
+    TEST_CHECK(arena.highWaterMark() == 2096);
+
+    arena.reset();
+    TEST_CHECK(arena.allocate(10, 8) != nullptr);
+    TEST_CHECK(arena.highWaterMark() == 2096);
+}
+
+void testAlignment() {
+    FrameArena arena(4096);
+    TEST_CHECK(arena.allocate(3, 1) != nullptr);
+    void* p = arena.allocate(64, 64);
+    TEST_CHECK(aligned(p, 64));
+    TEST_CHECK(arena.used() == 128);
+
+    // 溢出块同样满足对齐；扩容后按主缓冲全长计入，对齐填充也放得下
+    void* q = arena.allocate(8192, 256);
+    TEST_CHECK(aligned(q, 256));
+    arena.reset();
+    TEST_CHECK(arena.allocate(3, 1) != nullptr);
+    TEST_CHECK(aligned(arena.allocate(64, 64), 64));
+    TEST_CHECK(aligned(arena.allocate(8192, 256), 256));
+    TEST_CHECK(arena.overflowCount() == 0);
+}
+
+void testScratchResource() {
+    FrameArena arena(1024);
+    std::pmr::memory_resource* previous = setScratchResource(&arena);
+    TEST_CHECK(scratchResource() == &arena);
+    setScratchResource(nullptr);
+    TEST_CHECK(scratchResource() == std::pmr::get_default_resource());
+    setScratchResource(previous);
+}
+
+} // namespace
+
+int main() {
+    testHighWaterMark();
+    testAlignment();
+    testScratchResource();
+    return Test::finish("frame_arena_test");
+}
@@ -0,0 +1,149 @@
+// 点投影的差分测试：曲线 / 曲面上的最近点不比密集采样中的最近采样点更远，
+// 且返回的点等于返回参数处的曲线 / 曲面点、distance 等于到该点的距离
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "bezier_extraction.h"
+#include "point_projection.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+// 密集采样点都在曲线 / 曲面上，最近采样距离是真实最近距离的上界；余量只容纳 float 舍入
+constexpr float kSlack = 2e-5f;
+constexpr float kTolerance = 1e-4f;
+// 驻点判定的夹角余弦上限（偏导为差分近似）
+constexpr float kStationary = 1e-2f;
+
+float nearestSample(const std::vector<glm::vec3>& samples, const glm::vec3& q) {
+    float best = std::numeric_limits<float>::infinity();
+    for (const glm::vec3& p : samples) best = std::min(best, glm::dot(p - q, p - q));
+    return std::sqrt(best);
+}
+
+// [lo, hi]³ 内的随机查询点；flat 时 z = 0
+std::vector<glm::vec3> randomQueries(std::mt19937& rng, int count, float lo, float hi, bool flat) {
+    std::uniform_real_distribution<float> coordinate(lo, hi);
+    std::vector<glm::vec3> queries(count);
+    for (auto& q : queries) {
+        q.x = coordinate(rng);
+        q.y = coordinate(rng);
+        q.z = flat ? 0.0f : coordinate(rng);
+    }
+    return queries;
+}
+
+// ========================
+// 1. 曲线
+// ========================
+void testCurve(std::mt19937& rng, bool rational) {
+    const int degree = 3, numControlPoints = 6, denseSamples = 20000, numQueries = 1000;
+    // 平面上 [0, 1]² 内的控制点：曲线常有大曲率的弯折，Newton 在这里最容易不收敛
+    std::uniform_real_distribution<float> coordinate(0.0f, 1.0f);
+    std::vector<glm::vec3> points(numControlPoints);
+    for (auto& p : points) p = glm::vec3(coordinate(rng), coordinate(rng), 0.0f);
+    auto weights = rational ? Test::randomWeights(rng, numControlPoints) : std::vector<float>();
+    auto segments = extractBezierSegments(points, weights, degree);
+    PatchBVH bvh;
+    buildPatchBVH(bvh, segments);
+
+    auto dense = Test::referenceCurve(points, weights, degree, denseSamples);
+    auto queries = randomQueries(rng, numQueries, -0.25f, 1.25f, true);
+    std::vector<CurveProjection> results(numQueries);
+    projectPointsToCurve(segments, bvh, queries.data(), queries.size(), results.data());
+
+    int farther = 0;
+    for (int k = 0; k < numQueries; ++k) {
+        const CurveProjection& result = results[k];
+        TEST_CHECK(result.segment >= 0 && result.u >= 0.0f && result.u <= 1.0f);
+        if (result.distance > nearestSample(dense, queries[k]) + kSlack) ++farther;
+        TEST_CHECK(std::abs(glm::length(result.point - queries[k]) - result.distance) <= kTolerance);
+        glm::vec3 expected = result.u < 1.0f ? Test::referenceCurvePoint(points, weights, degree, result.u)
+                                             : points.back();
+        TEST_CHECK(glm::length(result.point - expected) <= kTolerance);
+    }
+    if (farther > 0) std::printf("curve (%s): %d of %d projections farther than dense sampling\n",
+                                 rational ? "rational" : "polynomial", farther, numQueries);
+    TEST_CHECK(farther == 0);
+}
+
+// ========================
+// 2. 曲面
+// ========================
+// 返回点必须是约束驻点：内部参数处 (p - q) 与该方向的偏导正交，边界上偏导方向不能再减小距离。
+// 偏导用参考曲面的差分近似，比较的是夹角余弦
+void checkStationary(const std::vector<std::vector<glm::vec3>>& grid, const std::vector<std::vector<float>>& weights,
+                     int degreeU, int degreeV, const glm::vec3& q, const SurfaceProjection& result) {
+    constexpr float h = 1e-3f;
+    glm::vec3 toPoint = glm::normalize(result.point - q);
+    for (int axis = 0; axis < 2; ++axis) {
+        glm::vec2 lo = result.uv, hi = result.uv;
+        lo[axis] = std::max(result.uv[axis] - h, 0.0f);
+        hi[axis] = std::min(result.uv[axis] + h, 1.0f);
+        glm::vec3 tangent = Test::referenceSurfacePoint(grid, weights, degreeU, degreeV, hi.x, hi.y) -
+                            Test::referenceSurfacePoint(grid, weights, degreeU, degreeV, lo.x, lo.y);
+        float cosine = glm::dot(toPoint, glm::normalize(tangent));
+        if (result.uv[axis] <= 0.0f) {
+            TEST_CHECK(cosine >= -kStationary);
+        } else if (result.uv[axis] >= 1.0f) {
+            TEST_CHECK(cosine <= kStationary);
+        } else {
+            TEST_CHECK(std::abs(cosine) <= kStationary);
+        }
+    }
+}
+
+void testSurface(std::mt19937& rng, bool rational) {
+    const int rows = 5, cols = 6, degreeU = 3, degreeV = 2, denseSamples = 200, numQueries = 500;
+    auto grid = Test::heightGrid(rng, rows, cols, 0.3f);
+    auto weights = rational ? Test::randomWeightGrid(rng, rows, cols) : std::vector<std::vector<float>>();
+    auto patches = extractBezierPatches(grid, weights, degreeU, degreeV);
+    PatchBVH bvh;
+    buildPatchBVH(bvh, patches);
+
+    // 曲面附近的查询：最近点所在的盆地没有歧义，不应比密集采样更远
+    auto dense = Test::referenceSurface(grid, weights, degreeU, degreeV, denseSamples, denseSamples);
+    std::uniform_real_distribution<float> param(0.0f, 1.0f), offset(-0.05f, 0.05f);
+    std::vector<glm::vec3> nearQueries(numQueries);
+    for (auto& q : nearQueries) {
+        float u = param(rng), v = param(rng);
+        q = Test::referenceSurfacePoint(grid, weights, degreeU, degreeV, u, v);
+        q += glm::vec3(offset(rng), offset(rng), offset(rng));
+    }
+    std::vector<SurfaceProjection> results(numQueries);
+    projectPointsToSurface(patches, bvh, nearQueries.data(), nearQueries.size(), results.data(), 1);
+
+    int farther = 0;
+    for (int k = 0; k < numQueries; ++k) {
+        const SurfaceProjection& result = results[k];
+        TEST_CHECK(result.patch >= 0);
+        TEST_CHECK(result.uv.x >= 0.0f && result.uv.x <= 1.0f && result.uv.y >= 0.0f && result.uv.y <= 1.0f);
+        if (result.distance > nearestSample(dense, nearQueries[k]) + kSlack) ++farther;
+        TEST_CHECK(std::abs(glm::length(result.point - nearQueries[k]) - result.distance) <= kTolerance);
+        glm::vec3 expected = Test::referenceSurfacePoint(grid, weights, degreeU, degreeV, result.uv.x, result.uv.y);
+        TEST_CHECK(glm::length(result.point - expected) <= kTolerance);
+    }
+    if (farther > 0) std::printf("surface (%s): %d of %d projections farther than dense sampling\n",
+                                 rational ? "rational" : "polynomial", farther, numQueries);
+    TEST_CHECK(farther == 0);
+
+    // 任意位置的查询（多线程）：迭代必须收敛到驻点，不能停在未收敛的迭代点上
+    auto queries = randomQueries(rng, 4 * static_cast<int>(kMinQueriesPerThread), -0.25f, 1.25f, false);
+    results.resize(queries.size());
+    projectPointsToSurface(patches, bvh, queries.data(), queries.size(), results.data());
+    for (size_t k = 0; k < queries.size(); ++k) {
+        if (results[k].distance > 1e-3f) checkStationary(grid, weights, degreeU, degreeV, queries[k], results[k]);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240625);
+    for (int trial = 0; trial < 10; ++trial) testCurve(rng, trial % 2 == 1);
+    for (int trial = 0; trial < 4; ++trial) testSurface(rng, trial % 2 == 1);
+    return Test::finish("point_projection_test");
+}
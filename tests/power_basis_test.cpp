@@ -0,0 +1,102 @@
+// 幂基 Horner 路径的差分测试：误差界、密集采样时的 evaluateBSpline / evaluateNURBS 路由，
+// 以及按修改计数复用 / 重建的 PowerBasisCache
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "bezier_extraction.h"
+#include "power_basis.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-4f;
+
+// ========================
+// 1. 误差界
+// ========================
+void testAccuracy(std::mt19937& rng) {
+    for (int degree = 1; degree <= kPowerBasisMaxDegree; ++degree) {
+        int numControlPoints = degree + 12;
+        int numSamples = kPowerBasisMinSamplesPerPoint * numControlPoints + 11;
+        TEST_CHECK(shouldUsePowerBasis(numControlPoints, degree, numSamples));
+        TEST_CHECK(!shouldUsePowerBasis(numControlPoints, degree, numControlPoints));
+
+        auto points = Test::randomPoints(rng, numControlPoints);
+        auto weights = Test::randomWeights(rng, numControlPoints);
+        auto reference = Test::referenceCurve(points, {}, degree, numSamples);
+        auto rationalReference = Test::referenceCurve(points, weights, degree, numSamples);
+
+        auto polynomial = buildPowerBasisCurve(extractBezierSegments(points, {}, degree), false);
+        auto rational = buildPowerBasisCurve(extractBezierSegments(points, weights, degree), true);
+        TEST_CHECK(polynomial.spanCount() == static_cast<size_t>(numControlPoints - degree));
+        TEST_CLOSE(evaluatePowerBasisCurve(polynomial, numSamples), reference, kTolerance);
+        TEST_CLOSE(evaluatePowerBasisCurve(rational, numSamples), rationalReference, kTolerance);
+
+        // 密集采样时 evaluateBSpline / evaluateNURBS 经幂基路径
+        TEST_CLOSE(evaluateBSpline(points, degree, numSamples), reference, kTolerance);
+        TEST_CLOSE(evaluateNURBS(points, weights, degree, numSamples), rationalReference, kTolerance);
+    }
+    TEST_CHECK(!shouldUsePowerBasis(20, kPowerBasisMaxDegree + 1, 100000));
+}
+
+// ========================
+// 2. PowerBasisCache
+// ========================
+void testCache(std::mt19937& rng) {
+    const int degree = 3, numControlPoints = 15;
+    const int numSamples = kPowerBasisMinSamplesPerPoint * numControlPoints;
+    auto points = Test::randomPoints(rng, numControlPoints);
+    auto weights = Test::randomWeights(rng, numControlPoints);
+    auto original = Test::referenceCurve(points, weights, degree, numSamples);
+
+    PowerBasisCache cache;
+    Generation pointsGeneration, weightsGeneration;
+    std::vector<glm::vec3> out(bsplineOutputSize(numControlPoints, degree, numSamples));
+    auto evaluate = [&] {
+        return evaluateNURBS(points, weights, degree, numSamples, cache, pointsGeneration.value,
+                             weightsGeneration.value, out.data(), out.size());
+    };
+    TEST_CHECK(evaluate() == out.size());
+    TEST_CHECK(cache.valid);
+    TEST_CLOSE(out, original, kTolerance);
+
+    // 修改计数不变时复用缓存（绕过计数的修改不可见）
+    points[7] += glm::vec3(0.5f, -0.25f, 0.125f);
+    evaluate();
+    TEST_CLOSE(out, original, kTolerance);
+
+    // 计数变化后按新控制点重新转换
+    pointsGeneration.bump();
+    evaluate();
+    auto moved = Test::referenceCurve(points, weights, degree, numSamples);
+    TEST_CLOSE(out, moved, kTolerance);
+
+    weights[3] *= 2.0f;
+    weightsGeneration.bump();
+    evaluate();
+    TEST_CLOSE(out, Test::referenceCurve(points, weights, degree, numSamples), kTolerance);
+
+    // invalidate() 强制重建
+    points[1] -= glm::vec3(0.25f);
+    cache.invalidate();
+    evaluate();
+    TEST_CLOSE(out, Test::referenceCurve(points, weights, degree, numSamples), kTolerance);
+
+    // 多项式曲线忽略权重计数；有理性变化时重建
+    std::vector<glm::vec3> polynomial(out.size());
+    evaluateBSpline(points, degree, numSamples, cache, pointsGeneration.value, polynomial.data(), polynomial.size());
+    TEST_CHECK(!cache.rational);
+    TEST_CLOSE(polynomial, Test::referenceCurve(points, {}, degree, numSamples), kTolerance);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240609);
+    testAccuracy(rng);
+    testCache(rng);
+    return Test::finish("power_basis_test");
+}
@@ -0,0 +1,74 @@
+// 批量内核差分测试：每个可用的 SimdLevel 下，*Batch 求值、evaluateCurveBatch（乱序参数）
+// 以及经批量内核路由的密集 evaluateBSpline / evaluateNURBS 都与标量参考一致
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "spline_simd.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-4f;
+
+void checkCurve(std::mt19937& rng, int degree, bool rational) {
+    int numControlPoints = degree + 1 + static_cast<int>(rng() % 24);
+    auto points = Test::randomPoints(rng, numControlPoints);
+    auto weights = rational ? Test::randomWeights(rng, numControlPoints) : std::vector<float>();
+
+    // 与批量版本相同的均匀采样布局
+    const int numSamples = 300;
+    auto reference = Test::referenceCurve(points, weights, degree, numSamples);
+    auto batch = rational ? evaluateNURBSBatch(points, weights, degree, numSamples)
+                          : evaluateBSplineBatch(points, degree, numSamples);
+    TEST_CLOSE(batch, reference, kTolerance);
+
+    // 密集采样：高次时 evaluateBSpline / evaluateNURBS 经批量内核，低次时经幂基或定长内核
+    const int denseSamples = kSimdBatchMinSamples + 37;
+    auto denseReference = Test::referenceCurve(points, weights, degree, denseSamples);
+    auto dense = rational ? evaluateNURBS(points, weights, degree, denseSamples)
+                          : evaluateBSpline(points, degree, denseSamples);
+    TEST_CLOSE(dense, denseReference, kTolerance);
+
+    // 乱序参数（含两端点）：同一批内的各通道落在不同节点区间
+    std::uniform_real_distribution<float> param(0.0f, 1.0f);
+    std::vector<float> params(203);
+    for (auto& u : params) u = param(rng);
+    params[0] = 0.0f;
+    params[101] = 1.0f;
+    ControlPointsSoA soa;
+    toSoA(points, weights, soa);
+    auto knots = generateClampedKnotVector(numControlPoints, degree);
+    std::vector<glm::vec3> scattered(params.size());
+    evaluateCurveBatch(soa, degree, knots, rational, params.data(), static_cast<int>(params.size()), scattered.data());
+    std::vector<glm::vec3> scatteredReference(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        scatteredReference[i] = Test::referenceCurvePoint(points, weights, degree, params[i]);
+    }
+    TEST_CLOSE(scattered, scatteredReference, kTolerance);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240611);
+    SimdLevel detected = detectSimdLevel();
+    std::printf("detected SIMD level: %s\n", simdLevelName(detected));
+
+    // 1..5 为定长内核范围，其余覆盖批量内核的通用路径与高次（> 15）标量回退
+    const int degrees[] = {1, 2, 3, 4, 5, 6, 7, 9, 15, 17};
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+        if (static_cast<int>(level) > static_cast<int>(detected)) continue;
+        setSimdLevel(level);
+        TEST_CHECK(getSimdLevel() == level);
+        for (int degree : degrees) {
+            checkCurve(rng, degree, false);
+            checkCurve(rng, degree, true);
+        }
+    }
+    setSimdLevel(detected);
+
+    return Test::finish("simd_batch_test");
+}
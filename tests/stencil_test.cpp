@@ -0,0 +1,154 @@
+// 求值模板的差分测试：曲线 / 曲面模板的稀疏求和与直接按定义求和的标量参考一致；
+// 逐点增量修补的细分与全量重建一致，脏区域覆盖所有变化的采样
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "stencil.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-4f;
+
+std::vector<glm::vec3> flatten(const std::vector<std::vector<glm::vec3>>& grid) {
+    std::vector<glm::vec3> flat;
+    for (const auto& row : grid) flat.insert(flat.end(), row.begin(), row.end());
+    return flat;
+}
+
+std::vector<float> flatten(const std::vector<std::vector<float>>& grid) {
+    std::vector<float> flat;
+    for (const auto& row : grid) flat.insert(flat.end(), row.begin(), row.end());
+    return flat;
+}
+
+// ========================
+// 1. 曲线模板
+// ========================
+void testCurveStencil(std::mt19937& rng) {
+    for (int degree = 1; degree <= 6; ++degree) {
+        int numControlPoints = degree + 7;
+        const int numSamples = 61;
+        auto points = Test::randomPoints(rng, numControlPoints);
+        auto weights = Test::randomWeights(rng, numControlPoints);
+
+        EvaluationStencil stencil;
+        buildCurveStencil(stencil, numControlPoints, degree, numSamples);
+        TEST_CHECK(stencil.vertexCount() == static_cast<size_t>(numSamples + 1));
+        TEST_CHECK(!updateCurveStencil(stencil, numControlPoints, degree, numSamples));
+        TEST_CLOSE(applyStencil(stencil, points), Test::referenceCurve(points, {}, degree, numSamples), kTolerance);
+        TEST_CLOSE(applyStencilRational(stencil, points, weights),
+                   Test::referenceCurve(points, weights, degree, numSamples), kTolerance);
+
+        // 调用方缓冲区版本：容量不足时不写入
+        std::vector<glm::vec3> out(stencil.vertexCount());
+        TEST_CHECK(applyStencil(stencil, points, out.data(), out.size() - 1) == 0);
+        TEST_CHECK(applyStencil(stencil, points, out.data(), out.size()) == out.size());
+        TEST_CLOSE(out, applyStencil(stencil, points), 0.0f);
+    }
+
+    // Bezier 即次数为控制点数 - 1 的钳位 B 样条
+    auto points = Test::randomPoints(rng, 6);
+    EvaluationStencil bezier;
+    buildCurveStencil(bezier, 6, 5, 40);
+    TEST_CLOSE(applyStencil(bezier, points), evaluateBezier(points, 40), kTolerance);
+
+    // 次数或采样数变化时重建
+    TEST_CHECK(updateCurveStencil(bezier, 6, 4, 40));
+    TEST_CHECK(updateCurveStencil(bezier, 6, 4, 41));
+    TEST_CHECK(bezier.vertexCount() == 42);
+}
+
+// ========================
+// 2. 曲面模板
+// ========================
+void testSurfaceStencil(std::mt19937& rng) {
+    const int rows = 8, cols = 6, uSamples = 29, vSamples = 17;
+    auto grid = Test::randomGrid(rng, rows, cols);
+    auto weightGrid = Test::randomWeightGrid(rng, rows, cols);
+    auto points = flatten(grid);
+    auto weights = flatten(weightGrid);
+    for (int degreeU = 1; degreeU <= 4; ++degreeU) {
+        int degreeV = 5 - degreeU;
+        EvaluationStencil stencil;
+        buildSurfaceStencil(stencil, rows, cols, degreeU, degreeV, uSamples, vSamples);
+        TEST_CHECK(stencil.vertexCount() == static_cast<size_t>((uSamples + 1) * (vSamples + 1)));
+        TEST_CHECK(!updateSurfaceStencil(stencil, rows, cols, degreeU, degreeV, uSamples, vSamples));
+        TEST_CLOSE(applyStencil(stencil, points),
+                   Test::referenceSurface(grid, {}, degreeU, degreeV, uSamples, vSamples), kTolerance);
+        TEST_CLOSE(applyStencilRational(stencil, points, weights),
+                   Test::referenceSurface(grid, weightGrid, degreeU, degreeV, uSamples, vSamples), kTolerance);
+    }
+}
+
+// ========================
+// 3. 增量细分
+// ========================
+void testIncrementalTessellation(std::mt19937& rng) {
+    const int rows = 8, cols = 6, degreeU = 3, degreeV = 2, uSamples = 29, vSamples = 17;
+    auto grid = Test::randomGrid(rng, rows, cols);
+    auto weightGrid = Test::randomWeightGrid(rng, rows, cols);
+    auto points = flatten(grid);
+    auto weights = flatten(weightGrid);
+
+    EvaluationStencil stencil;
+    buildSurfaceStencil(stencil, rows, cols, degreeU, degreeV, uSamples, vSamples);
+    SurfaceTessellation incremental;
+    rebuildTessellation(incremental, stencil, points, weights);
+    TEST_CHECK(incremental.hasDirtyRange());
+    clearTessellationDirty(incremental);
+    TEST_CHECK(!incremental.hasDirtyRange());
+
+    std::uniform_int_distribution<int> pickRow(0, rows - 1), pickCol(0, cols - 1);
+    for (int edit = 0; edit < 20; ++edit) {
+        int row = pickRow(rng), col = pickCol(rng);
+        size_t k = static_cast<size_t>(row) * cols + col;
+        glm::vec3 newPoint = Test::randomPoints(rng, 1)[0];
+        float newWeight = Test::randomWeights(rng, 1)[0];
+        auto before = incremental.positions;
+        uint64_t generation = incremental.generation.value;
+
+        updateTessellationPoint(incremental, stencil, row, col, points[k], weights[k], newPoint, newWeight);
+        points[k] = newPoint;
+        weights[k] = newWeight;
+        grid[row][col] = newPoint;
+        weightGrid[row][col] = newWeight;
+        TEST_CHECK(incremental.generation.value != generation);
+
+        // 单点修改的脏区域即其支撑范围，范围外的采样不变
+        int uBegin, uEnd, vBegin, vEnd;
+        basisSupportRange(stencil.basisU, row, uBegin, uEnd);
+        basisSupportRange(stencil.basisV, col, vBegin, vEnd);
+        TEST_CHECK(incremental.dirtyUBegin == uBegin && incremental.dirtyUEnd == uEnd);
+        TEST_CHECK(incremental.dirtyVBegin == vBegin && incremental.dirtyVEnd == vEnd);
+        bool outsideUnchanged = true;
+        for (int i = 0; i <= uSamples; ++i) {
+            for (int j = 0; j <= vSamples; ++j) {
+                bool inside = i >= uBegin && i < uEnd && j >= vBegin && j < vEnd;
+                size_t v = static_cast<size_t>(i) * (vSamples + 1) + j;
+                if (!inside && incremental.positions[v] != before[v]) outsideUnchanged = false;
+            }
+        }
+        TEST_CHECK(outsideUnchanged);
+        clearTessellationDirty(incremental);
+    }
+
+    SurfaceTessellation rebuilt;
+    rebuildTessellation(rebuilt, stencil, points, weights);
+    TEST_CLOSE(incremental.positions, rebuilt.positions, kTolerance);
+    TEST_CLOSE(incremental.positions,
+               Test::referenceSurface(grid, weightGrid, degreeU, degreeV, uSamples, vSamples), kTolerance);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240602);
+    testCurveStencil(rng);
+    testSurfaceStencil(rng);
+    testIncrementalTessellation(rng);
+    return Test::finish("stencil_test");
+}
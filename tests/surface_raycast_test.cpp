@@ -0,0 +1,127 @@
+// 射线与曲面求交的测试：B 样条与带权 NURBS 控制网格上，命中点落在射线上且等于 hit.uv 处的曲面点；
+// 明显错过的射线返回 false；粗网格全部错过的掠射交点由最近采样点初值找到
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "control_net.h"
+#include "bezier_extraction.h"
+#include "surface_raycast.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-4f;
+
+struct Surface {
+    std::vector<std::vector<glm::vec3>> grid;
+    std::vector<std::vector<float>> weights;  // 为空时为 B 样条
+    int degreeU, degreeV;
+};
+
+void checkHit(const Surface& surface, const SurfaceHit& hit, const glm::vec3& origin, const glm::vec3& dir) {
+    TEST_CHECK(hit.patch >= 0);
+    TEST_CHECK(hit.t >= 0.0f);
+    TEST_CHECK(hit.uv.x >= 0.0f && hit.uv.x <= 1.0f && hit.uv.y >= 0.0f && hit.uv.y <= 1.0f);
+    glm::vec3 expected =
+        Test::referenceSurfacePoint(surface.grid, surface.weights, surface.degreeU, surface.degreeV, hit.uv.x, hit.uv.y);
+    TEST_CHECK(glm::length(hit.point - expected) <= kTolerance);
+    TEST_CHECK(glm::length(origin + hit.t * dir - hit.point) <= kTolerance);
+}
+
+// ========================
+// 1. 命中与错过
+// ========================
+void testHitsAndMisses(std::mt19937& rng, const Surface& surface) {
+    auto patches = extractBezierPatches(surface.grid, surface.weights, surface.degreeU, surface.degreeV);
+    PatchBVH bvh;
+    buildPatchBVH(bvh, patches);
+    std::uniform_real_distribution<float> position(0.05f, 0.95f), tilt(-0.1f, 0.1f);
+
+    for (int k = 0; k < 50; ++k) {
+        glm::vec3 target(position(rng), position(rng), 0.0f);
+        glm::vec3 dir(tilt(rng), tilt(rng), k % 2 == 0 ? -1.0f : 1.0f);
+        glm::vec3 origin = target - 2.0f * dir;
+        SurfaceHit hit;
+        bool found = intersectSurface(patches, bvh, origin, dir, hit);
+        TEST_CHECK(found);
+        if (found) checkHit(surface, hit, origin, dir);
+    }
+
+    SurfaceHit hit;
+    TEST_CHECK(!intersectSurface(patches, bvh, glm::vec3(2.0f, 0.5f, 2.0f), glm::vec3(0.0f, 0.0f, -1.0f), hit));
+    TEST_CHECK(!intersectSurface(patches, bvh, glm::vec3(0.5f, 0.5f, 2.0f), glm::vec3(0.0f, 0.0f, 1.0f), hit));
+    TEST_CHECK(!intersectSurface(patches, bvh, glm::vec3(-1.0f, 0.5f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), hit));
+    TEST_CHECK(!intersectSurface(patches, bvh, glm::vec3(0.5f, 0.5f, 2.0f), glm::vec3(0.0f), hit));
+}
+
+// ========================
+// 2. raycastSurface 缓存
+// ========================
+void testCachedRaycast(Surface surface) {
+    ControlNet net = makeControlNet(surface.grid, surface.weights);
+    bool rational = !surface.weights.empty();
+    SurfaceRaycastCache cache;
+    const glm::vec3 origin(0.4f, 0.6f, 2.0f), dir(0.0f, 0.0f, -1.0f);
+
+    SurfaceHit hit;
+    TEST_CHECK(raycastSurface(cache, net, rational, surface.degreeU, surface.degreeV, origin, dir, hit));
+    checkHit(surface, hit, origin, dir);
+
+    // 修改控制点后按新的网格重建面片与 BVH
+    int row = static_cast<int>(surface.grid.size()) / 2, col = static_cast<int>(surface.grid[0].size()) / 2;
+    surface.grid[row][col].z += 0.5f;
+    net.setPoint(row, col, surface.grid[row][col]);
+    SurfaceHit moved;
+    TEST_CHECK(raycastSurface(cache, net, rational, surface.degreeU, surface.degreeV, origin, dir, moved));
+    checkHit(surface, moved, origin, dir);
+    TEST_CHECK(moved.point.z > hit.point.z);
+    TEST_CHECK(cache.bvhGeneration == cache.patches.generation);
+}
+
+// ========================
+// 3. 掠射
+// ========================
+// 双二次单面片 z = 4u(1-u)·v(1-v)，x = u、y = v。沿 v = 0.375 的缓升射线从顶部下方擦过：
+// 曲面上凸，4 × 4 粗三角网格在这条线上最高只到 0.21875，射线整段在粗网格之上，
+// 只能从离射线最近的采样点出发求交；两个交点中较近的在 u ≈ 0.3733 处
+void testGrazing() {
+    Surface dome;
+    dome.degreeU = dome.degreeV = 2;
+    dome.grid.assign(3, std::vector<glm::vec3>(3));
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) dome.grid[r][c] = glm::vec3(0.5f * r, 0.5f * c, r == 1 && c == 1 ? 1.0f : 0.0f);
+    }
+    const glm::vec3 origin(-0.5f, 0.375f, 0.132f), dir(1.0f, 0.0f, 0.1f);
+
+    for (bool rational : {false, true}) {
+        // 权重全为 1 的 NURBS 与 B 样条是同一张曲面，走有理求值路径
+        if (rational) dome.weights.assign(3, std::vector<float>(3, 1.0f));
+        auto patches = extractBezierPatches(dome.grid, dome.weights, 2, 2);
+        PatchBVH bvh;
+        buildPatchBVH(bvh, patches);
+        SurfaceHit hit;
+        bool found = intersectSurface(patches, bvh, origin, dir, hit);
+        TEST_CHECK(found);
+        if (!found) continue;
+        checkHit(dome, hit, origin, dir);
+        TEST_CHECK(std::abs(hit.uv.x - 0.37333f) <= 1e-3f);
+        TEST_CHECK(std::abs(hit.uv.y - 0.375f) <= 1e-3f);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240624);
+    Surface bspline{Test::heightGrid(rng, 7, 6, 0.2f), {}, 3, 2};
+    Surface nurbs{Test::heightGrid(rng, 6, 8, 0.2f), Test::randomWeightGrid(rng, 6, 8), 2, 3};
+    testHitsAndMisses(rng, bspline);
+    testHitsAndMisses(rng, nurbs);
+    testCachedRaycast(bspline);
+    testCachedRaycast(nurbs);
+    testGrazing();
+    return Test::finish("surface_raycast_test");
+}
@@ -0,0 +1,102 @@
+// 张量积曲面求值的差分测试：两遍求值与直接按定义求和的标量参考一致，
+// Bezier 曲面的矩阵形式与双精度 de Casteljau 一致
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "spline.h"
+#include "test_common.h"
+
+using namespace Spline;
+
+namespace {
+
+constexpr float kTolerance = 1e-4f;
+
+// ========================
+// 1. B 样条 / NURBS 曲面（两遍求值）
+// ========================
+void testTensorSurfaces(std::mt19937& rng) {
+    struct Case { int rows, cols, degreeU, degreeV, uSamples, vSamples; };
+    const Case cases[] = {
+        {4, 4, 3, 3, 10, 10},
+        {9, 6, 2, 5, 37, 13},
+        {7, 11, 6, 1, 20, 50},  // 定长内核范围之外的次数
+        {10, 8, 7, 7, 16, 16},
+        {3, 12, 1, 3, 1, 64},
+    };
+    for (const Case& c : cases) {
+        auto grid = Test::randomGrid(rng, c.rows, c.cols);
+        auto weights = Test::randomWeightGrid(rng, c.rows, c.cols);
+        TEST_CLOSE(evaluateBSplineSurface(grid, c.degreeU, c.degreeV, c.uSamples, c.vSamples),
+                   Test::referenceSurface(grid, {}, c.degreeU, c.degreeV, c.uSamples, c.vSamples), kTolerance);
+        TEST_CLOSE(evaluateNURBSSurface(grid, weights, c.degreeU, c.degreeV, c.uSamples, c.vSamples),
+                   Test::referenceSurface(grid, weights, c.degreeU, c.degreeV, c.uSamples, c.vSamples), kTolerance);
+    }
+
+    // 次数超过控制点数 - 1 时按求值函数的规则截断
+    auto grid = Test::randomGrid(rng, 4, 3);
+    TEST_CLOSE(evaluateBSplineSurface(grid, 6, 5, 12, 12), Test::referenceSurface(grid, {}, 3, 2, 12, 12), kTolerance);
+}
+
+// ========================
+// 2. Bezier 曲面（伯恩斯坦矩阵乘）
+// ========================
+glm::dvec3 deCasteljau(std::vector<glm::dvec3> points, double t) {
+    for (size_t k = points.size() - 1; k > 0; --k) {
+        for (size_t i = 0; i < k; ++i) points[i] = (1.0 - t) * points[i] + t * points[i + 1];
+    }
+    return points[0];
+}
+
+// 先沿 v 对每行求值，再沿 u 对得到的列求值
+std::vector<glm::vec3> referenceBezierSurface(const std::vector<std::vector<glm::vec3>>& grid,
+                                              int uSamples, int vSamples) {
+    std::vector<glm::vec3> surface;
+    std::vector<glm::dvec3> row(grid[0].size()), column(grid.size());
+    for (int i = 0; i <= uSamples; ++i) {
+        double u = static_cast<double>(i) / uSamples;
+        for (int j = 0; j <= vSamples; ++j) {
+            double v = static_cast<double>(j) / vSamples;
+            for (size_t r = 0; r < grid.size(); ++r) {
+                for (size_t c = 0; c < grid[r].size(); ++c) row[c] = glm::dvec3(grid[r][c]);
+                column[r] = deCasteljau(row, v);
+            }
+            surface.push_back(glm::vec3(deCasteljau(column, u)));
+        }
+    }
+    return surface;
+}
+
+void testBezierSurface(std::mt19937& rng) {
+    struct Case { int rows, cols, uSamples, vSamples; };
+    const Case cases[] = {
+        {2, 2, 4, 4},
+        {4, 4, 20, 20},
+        {3, 7, 33, 9},
+        {13, 5, 70, 70},
+        {25, 4, 100, 30},  // 高次：两端基函数值低于 float 精度，矩阵中置零
+    };
+    BezierSurfaceCache cache;
+    for (const Case& c : cases) {
+        auto grid = Test::randomGrid(rng, c.rows, c.cols);
+        auto reference = referenceBezierSurface(grid, c.uSamples, c.vSamples);
+        TEST_CLOSE(evaluateBezierSurface(grid, c.uSamples, c.vSamples), reference, kTolerance);
+
+        // 同一个缓存跨尺寸 / 采样数复用：变化时重新计算，结果与一次性版本一致
+        std::vector<glm::vec3> cached(surfaceOutputSize(c.rows, c.cols, c.uSamples, c.vSamples));
+        TEST_CHECK(evaluateBezierSurface(grid, c.uSamples, c.vSamples, cache, cached.data(), cached.size()) ==
+                   cached.size());
+        TEST_CHECK(cache.u.degree == c.rows - 1 && cache.u.numSamples == c.uSamples);
+        TEST_CHECK(cache.v.degree == c.cols - 1 && cache.v.numSamples == c.vSamples);
+        TEST_CLOSE(cached, reference, kTolerance);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240605);
+    testTensorSurfaces(rng);
+    testBezierSurface(rng);
+    return Test::finish("surface_test");
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "spline.h"
+
+// 极简测试辅助：失败时打印位置与信息并计数，main 以失败数作为退出码
+namespace Test {
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+inline void check(bool condition, const char* file, int line, const char* what) {
+    if (condition) return;
+    ++failureCount();
+    std::printf("%s:%d: check failed: %s\n", file, line, what);
+}
+
+// 两组点逐元素的最大距离；长度不同时为 +inf
+inline float maxDistance(const std::vector<glm::vec3>& a, const std::vector<glm::vec3>& b) {
+    if (a.size() != b.size()) return std::numeric_limits<float>::infinity();
+    float worst = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) worst = std::max(worst, glm::length(a[i] - b[i]));
+    return worst;
+}
+
+inline void checkClose(const std::vector<glm::vec3>& actual, const std::vector<glm::vec3>& expected,
+                       float tolerance, const char* file, int line, const char* what) {
+    float error = maxDistance(actual, expected);
+    if (error <= tolerance) return;
+    ++failureCount();
+    std::printf("%s:%d: %s: max error %g > %g (sizes %zu / %zu)\n", file, line, what, error, tolerance,
+                actual.size(), expected.size());
+}
+
+inline int finish(const char* name) {
+    if (failureCount() == 0) {
+        std::printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    std::printf("%s: %d check(s) failed\n", name, failureCount());
+    return 1;
+}
+
+inline std::vector<glm::vec3> randomPoints(std::mt19937& rng, int count) {
+    std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+    std::vector<glm::vec3> points(count);
+    for (auto& p : points) p = glm::vec3(coord(rng), coord(rng), coord(rng));
+    return points;
+}
+
+// 正权重，跨度足以让有理项明显偏离多项式曲线
+inline std::vector<float> randomWeights(std::mt19937& rng, int count) {
+    std::uniform_real_distribution<float> weight(0.25f, 4.0f);
+    std::vector<float> weights(count);
+    for (auto& w : weights) w = weight(rng);
+    return weights;
+}
+
+// 钳位、内部节点随机（含重节点）的节点向量
+inline std::vector<float> randomClampedKnots(std::mt19937& rng, int numControlPoints, int degree) {
+    std::uniform_real_distribution<float> param(0.0f, 1.0f);
+    std::vector<float> knots(numControlPoints + degree + 1);
+    for (int i = 0; i <= degree; ++i) {
+        knots[i] = 0.0f;
+        knots[knots.size() - 1 - i] = 1.0f;
+    }
+    std::vector<float> interior(numControlPoints - degree - 1);
+    for (auto& k : interior) k = param(rng);
+    if (interior.size() >= 2) interior[1] = interior[0];
+    std::sort(interior.begin(), interior.end());
+    std::copy(interior.begin(), interior.end(), knots.begin() + degree + 1);
+    return knots;
+}
+
+// 标量参考：钳位均匀节点上直接按定义求和（double 累加）；weights 为空时为多项式曲线
+inline glm::vec3 referenceCurvePoint(const std::vector<glm::vec3>& points, const std::vector<float>& weights,
+                                     int degree, float u) {
+    int n = static_cast<int>(points.size());
+    auto knots = Spline::generateClampedKnotVector(n, degree);
+    int span = Spline::findKnotSpan(n, degree, u, knots);
+    std::vector<float> N(degree + 1);
+    Spline::basisFunctions(span, u, degree, knots, N.data());
+    glm::dvec3 numerator(0.0);
+    double denominator = 0.0;
+    for (int a = 0; a <= degree; ++a) {
+        int i = span - degree + a;
+        double w = weights.empty() ? 1.0 : weights[i];
+        numerator += double(N[a]) * w * glm::dvec3(points[i]);
+        denominator += double(N[a]) * w;
+    }
+    return glm::vec3(numerator / denominator);
+}
+
+// 与 evaluateBSpline / evaluateNURBS 相同的输出布局：[0, 1) 上 numSamples 个均匀采样加终点
+inline std::vector<glm::vec3> referenceCurve(const std::vector<glm::vec3>& points, const std::vector<float>& weights,
+                                             int degree, int numSamples) {
+    degree = std::min(degree, static_cast<int>(points.size()) - 1);
+    std::vector<glm::vec3> curve(numSamples + 1);
+    for (int s = 0; s < numSamples; ++s) {
+        curve[s] = referenceCurvePoint(points, weights, degree, static_cast<float>(s) / numSamples);
+    }
+    curve[numSamples] = points.back();
+    return curve;
+}
+
+inline std::vector<std::vector<glm::vec3>> randomGrid(std::mt19937& rng, int rows, int cols) {
+    std::vector<std::vector<glm::vec3>> grid;
+    for (int r = 0; r < rows; ++r) grid.push_back(randomPoints(rng, cols));
+    return grid;
+}
+
+inline std::vector<std::vector<float>> randomWeightGrid(std::mt19937& rng, int rows, int cols) {
+    std::vector<std::vector<float>> grid;
+    for (int r = 0; r < rows; ++r) grid.push_back(randomWeights(rng, cols));
+    return grid;
+}
+
+// x、y 随行列均匀分布于 [0, 1]、z 在 [-amplitude, amplitude] 内随机的高度场网格：
+// 曲面是 (x, y) 上的单值函数，竖直方向的射线在参数域内部恰好穿过一次
+inline std::vector<std::vector<glm::vec3>> heightGrid(std::mt19937& rng, int rows, int cols, float amplitude) {
+    std::uniform_real_distribution<float> height(-amplitude, amplitude);
+    std::vector<std::vector<glm::vec3>> grid(rows, std::vector<glm::vec3>(cols));
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            grid[r][c] = glm::vec3(static_cast<float>(r) / (rows - 1), static_cast<float>(c) / (cols - 1), height(rng));
+        }
+    }
+    return grid;
+}
+
+// 张量积曲面在 (u, v) 处的标量参考：u 方向对应行，weights 为空时为多项式曲面
+inline glm::vec3 referenceSurfacePoint(const std::vector<std::vector<glm::vec3>>& points,
+                                       const std::vector<std::vector<float>>& weights,
+                                       int degreeU, int degreeV, float u, float v) {
+    int rows = static_cast<int>(points.size());
+    int cols = static_cast<int>(points[0].size());
+    auto knotsU = Spline::generateClampedKnotVector(rows, degreeU);
+    auto knotsV = Spline::generateClampedKnotVector(cols, degreeV);
+    std::vector<float> Nu(degreeU + 1), Nv(degreeV + 1);
+    int spanU = Spline::findKnotSpan(rows, degreeU, u, knotsU);
+    int spanV = Spline::findKnotSpan(cols, degreeV, v, knotsV);
+    Spline::basisFunctions(spanU, u, degreeU, knotsU, Nu.data());
+    Spline::basisFunctions(spanV, v, degreeV, knotsV, Nv.data());
+    glm::dvec3 numerator(0.0);
+    double denominator = 0.0;
+    for (int a = 0; a <= degreeU; ++a) {
+        for (int b = 0; b <= degreeV; ++b) {
+            int r = spanU - degreeU + a, c = spanV - degreeV + b;
+            double w = double(Nu[a]) * Nv[b] * (weights.empty() ? 1.0 : weights[r][c]);
+            numerator += w * glm::dvec3(points[r][c]);
+            denominator += w;
+        }
+    }
+    return glm::vec3(numerator / denominator);
+}
+
+// 与 evaluate*Surface 相同的输出布局：行优先 (uSamples + 1) × (vSamples + 1)
+inline std::vector<glm::vec3> referenceSurface(const std::vector<std::vector<glm::vec3>>& points,
+                                               const std::vector<std::vector<float>>& weights,
+                                               int degreeU, int degreeV, int uSamples, int vSamples) {
+    std::vector<glm::vec3> surface;
+    for (int i = 0; i <= uSamples; ++i) {
+        float u = static_cast<float>(i) / uSamples;
+        for (int j = 0; j <= vSamples; ++j) {
+            float v = static_cast<float>(j) / vSamples;
+            surface.push_back(referenceSurfacePoint(points, weights, degreeU, degreeV, u, v));
+        }
+    }
+    return surface;
+}
+
+} // namespace Test
+
+#define TEST_CHECK(condition) Test::check((condition), __FILE__, __LINE__, #condition)
+#define TEST_CLOSE(actual, expected, tolerance) \
+    Test::checkClose((actual), (expected), (tolerance), __FILE__, __LINE__, #actual)